@@ -20,15 +20,115 @@
 #define BEAMC 0x30
 #define BEAMD 0x37
 
+//Longest chain, each beam takes a few bytes of SRAM for its address and caches
+#ifndef BEAM_MAX_BEAMS
+#define BEAM_MAX_BEAMS 4
+#endif
+
+//TCA9548A I2C multiplexer, for chains with more beams than Beam addresses
+#define BEAM_MUX 0x70
+#define BEAM_NO_MUX 0xFF
+
 #define MAXFRAME 36
 #define SPACE 3
 #define KERNING 1
 
+//Shadow copy of the uploaded frames, used to send only the registers that changed.
+//Needs BEAM_SHADOW_BEAMS * BEAM_SHADOW_FRAMES * 24 bytes of SRAM, define
+//BEAM_SHADOW_FRAMES as 0 to disable it. Off by default on 2 KB SRAM boards.
+#ifndef BEAM_SHADOW_FRAMES
+#if defined(RAMEND) && (RAMEND < 0x900)
+#define BEAM_SHADOW_FRAMES 0
+#else
+#define BEAM_SHADOW_FRAMES MAXFRAME
+#endif
+#endif
+
+//I2C transactions a poll() call may spend on an upload
+#ifndef BEAM_POLL_TRANSACTIONS
+#define BEAM_POLL_TRANSACTIONS 16
+#endif
+
+//Beams at the start of the chain whose frames are tracked, for the shadow and
+//for clearing stale frames
+#ifndef BEAM_SHADOW_BEAMS
+#define BEAM_SHADOW_BEAMS 4
+#endif
+
+//Gray levels kept per beam, so that brightness changes only send the PWM
+//registers that changed. Needs BEAM_GRAY_BEAMS * 120 bytes of SRAM, off
+//by default on 2 KB SRAM boards. Beams without kept levels get all their
+//PWM registers on every change, the dimmer and effects treat their levels
+//as 255, and a reset brings back the dimmer but not single LED levels.
+#ifndef BEAM_GRAY_BEAMS
+#if defined(RAMEND) && (RAMEND < 0x900)
+#define BEAM_GRAY_BEAMS 0
+#else
+#define BEAM_GRAY_BEAMS BEAM_SHADOW_BEAMS
+#endif
+#endif
+
+//Beams at the start of the chain whose last stream() frame is kept, to fill
+//the ring with it once the source has run out. Needs BEAM_STREAM_BEAMS * 15
+//bytes of SRAM, off by default on 2 KB SRAM boards. Other beams fill it with
+//blank frames, which only show when poll() falls behind at the very end.
+#ifndef BEAM_STREAM_BEAMS
+#if defined(RAMEND) && (RAMEND < 0x900)
+#define BEAM_STREAM_BEAMS 0
+#else
+#define BEAM_STREAM_BEAMS BEAM_MAX_BEAMS
+#endif
+#endif
+
+//Time limit of one I2C transaction in microseconds, on cores whose Wire has one
+#ifndef BEAM_I2C_TIMEOUT
+#define BEAM_I2C_TIMEOUT 25000
+#endif
+
+//Extra attempts for a failed I2C transaction before its beam is taken offline
+#ifndef BEAM_I2C_RETRIES
+#define BEAM_I2C_RETRIES 2
+#endif
+
+//Per call I2C counters and phase timings, see getInstrument(). Takes about
+//460 bytes of SRAM, define BEAM_INSTRUMENT as 1 to compile it in.
+#ifndef BEAM_INSTRUMENT
+#define BEAM_INSTRUMENT 0
+#endif
+
+//Ring buffer of trace records, see drain(). Each record takes 8 bytes of
+//SRAM, define BEAM_TRACE as 1 to compile it in. BEAM_TRACE_RECORDS has to
+//be a power of two up to 128.
+#ifndef BEAM_TRACE
+#define BEAM_TRACE 0
+#endif
+
+#ifndef BEAM_TRACE_RECORDS
+#define BEAM_TRACE_RECORDS 32
+#endif
+
+//BEAM_MAX_BEAMS, BEAM_SHADOW_BEAMS, BEAM_SHADOW_FRAMES, BEAM_GRAY_BEAMS,
+//BEAM_STREAM_BEAMS, BEAM_INSTRUMENT, BEAM_TRACE and BEAM_TRACE_RECORDS
+//change the layout of
+//the Beam class, so beam.cpp and every sketch file have to see the same
+//values. Change them in this file or as build flags, a #define in the
+//sketch does not reach beam.cpp. A sketch built with other values fails
+//to link, with an undefined reference to BeamChain<0, 1>::start(BeamLayout<...>).
+template <int MaxBeams, int ShadowBeams, int ShadowFrames, int GrayBeams, int StreamBeams, int Instrument, int Trace, int TraceRecords>
+struct BeamLayout {};
+typedef BeamLayout<BEAM_MAX_BEAMS, BEAM_SHADOW_BEAMS, BEAM_SHADOW_FRAMES, BEAM_GRAY_BEAMS, BEAM_STREAM_BEAMS,
+    BEAM_INSTRUMENT, BEAM_TRACE, BEAM_TRACE ? BEAM_TRACE_RECORDS : 0> BeamBuildLayout;
+
 #define REGSEL 0xFD
+#define REGSEL_NONE 0x00
 
 //RAM section address
+#define PWMSET 0x40
 #define CTRL 0xC0
 
+//First PWM register of a blink/PWM set, the blink bits come before it
+#define PWM_OFFSET 0x18
+
 //Sub Register address
 #define PIC 0x00
 #define MOV 0x01
@@ -41,6 +141,25 @@
 #define IRQFRAME 0x08
 #define SHDN 0x09
 #define CLKSYNC 0x0B
+#define IRQSTATUS 0x0E
+
+//Interrupt mask bits
+#define IRQ_MOVIE 0x01
+
+//Status returned by the public calls, 1 to 5 are the codes of Wire.endTransmission()
+#define BEAM_OK 0
+#define BEAM_ERR_LENGTH 1
+#define BEAM_ERR_NACK_ADDR 2
+#define BEAM_ERR_NACK_DATA 3
+#define BEAM_ERR_BUS 4
+#define BEAM_ERR_TIMEOUT 5
+#define BEAM_ERR_READ 6
+#define BEAM_ERR_OFFLINE 7
+#define BEAM_ERR_ARGUMENT 8
+
+//Chain modes, beams behaving like one long Beam or a single Beam unit
+#define BEAM_SINGLE 0
+#define BEAM_CHAIN 1
 
 //User modes
 #define PICTURE 0x01
@@ -52,46 +171,367 @@
 #define FADEON 1
 #define FADEOFF 0
 
+//I2C traffic counters, see getStats()
+struct BeamStats {
+    uint32_t transactions;
+    uint32_t bytes;
+    uint32_t regselHits;
+    uint32_t regselMisses;
+    uint32_t errors;
+    uint32_t recoveries;
+};
+
+//Public calls the instrumentation counts separately, calls sharing a line share an entry
+#define BEAM_API_OTHER 0
+#define BEAM_API_BEGIN 1        //begin(), initBeam()
+#define BEAM_API_PRINT 2        //print(), printAsync()
+#define BEAM_API_PRINT_FRAME 3
+#define BEAM_API_PRINT_STATIC 4 //printStatic(), printStaticAsync()
+#define BEAM_API_FLIP 5
+#define BEAM_API_DRAW 6         //draw(), drawAsync()
+#define BEAM_API_STREAM 7       //stream(), marquee()
+#define BEAM_API_PLAY 8         //play(), playAsync()
+#define BEAM_API_POLL 9
+#define BEAM_API_SETTINGS 10    //setScroll(), setSpeed(), setLoops(), setMode(), display()
+#define BEAM_API_GRAY 11        //setBrightness(), loadGrayFrame(), setDimmer()
+#define BEAM_API_EFFECT 12      //breathe(), crossfade(), blink(), stopEffect()
+#define BEAM_API_LOAD_FRAME 13
+#define BEAM_API_STATUS 14      //status(), checkStatus()
+#define BEAM_API_COUNT 15
+
+//What the calls of one BEAM_API_ entry cost, see getInstrument()
+struct BeamApiStats {
+    uint32_t calls;
+    uint32_t transactions;
+    uint32_t bytes;
+    uint32_t regselWrites;
+    uint32_t statusPolls;
+    uint32_t errors;
+    uint32_t micros;
+};
+
+//Time spent in one phase of getting frames to the beams
+struct BeamPhaseTiming {
+    uint32_t count;
+    uint32_t micros;
+    uint32_t maxMicros;
+};
+
+//Snapshot of the instrumentation: text rendered into columns, bitmaps and
+//columns converted to register images, and register images sent
+struct BeamInstrument {
+    BeamApiStats api[BEAM_API_COUNT];
+    BeamPhaseTiming render;
+    BeamPhaseTiming convert;
+    BeamPhaseTiming upload;
+};
+
+//Trace events, see drain(). BEAM_TRACE_NONE stands for no beam or frame
+#define BEAM_EV_JOB 1           //upload started, frame = frames to upload, data = job kind
+#define BEAM_EV_JOB_DONE 2      //upload finished
+#define BEAM_EV_INIT 3          //beam configured after a reset
+#define BEAM_EV_RENDER 4        //frame of text rendered, data = columns filled
+#define BEAM_EV_FRAME 5         //frame written, data = registers sent
+#define BEAM_EV_PLAY 6          //playback started on beam
+#define BEAM_EV_HANDOFF 7       //playback handed on to beam
+#define BEAM_EV_STATUS 8        //frame status read, frame = frame on show
+#define BEAM_EV_UNDERRUN 9      //stream playback caught up with the upload at frame
+#define BEAM_EV_RETRY 10        //I2C attempt failed, data = status
+#define BEAM_EV_OFFLINE 11      //beam taken offline, data = status
+#define BEAM_EV_RECOVER 12      //bus recovered
+#define BEAM_TRACE_NONE 0xFF
+
+struct BeamTraceRecord {
+    uint8_t event;
+    uint8_t beam;
+    uint8_t frame;
+    uint8_t data;
+    uint32_t micros;
+};
+
+//Time spent in the last reset pulse and initBeam() phases, see getTiming()
+struct BeamTiming {
+    uint32_t resetMicros;
+    uint32_t configMicros;
+    uint32_t framesMicros;
+    uint32_t pwmMicros;
+};
+
+//Supplies frame index of an animation for the n-th beam, see stream()
+typedef bool (*BeamFrameSource)(uint32_t index, uint8_t beam, uint8_t *frame);
+
+//Shared by every BeamChain, only one of them at a time can own the IRQ pin
+class BeamIrq {
+  protected:
+    static void *_irqOwner;
+};
+
+/*
+    The Beam driver, with the length and mode of the chain as template
+    parameters. Beam is BeamChain<0>, its chain is set up at run time by
+    the constructors. Firmware that always drives the same sign can fix
+    the chain at compile time instead:
+
+        BeamChain<3> b = BeamChain<3>(RSTPIN, IRQPIN);
+        BeamChain<1, BEAM_SINGLE> c = BeamChain<1, BEAM_SINGLE>(RSTPIN, IRQPIN, 0, BEAMB);
+
+    The chain length, the beam addresses, the frame offsets and the LED
+    current are then constants, so the branches for other lengths and for
+    the other mode are compiled out, and the per beam arrays only take
+    Count entries. Fixed chains use the four Beam addresses on the main
+    bus, multiplexers need Beam. A fixed chain is built in the sketch file
+    that uses it, from beamchain.h.
+*/
+template <uint8_t Count, uint8_t Mode = BEAM_CHAIN>
+class BeamChain : BeamIrq {
+    static_assert(Mode == BEAM_CHAIN || Mode == BEAM_SINGLE, "Mode is BEAM_CHAIN or BEAM_SINGLE");
+    static_assert(Count <= 4 && Count <= BEAM_MAX_BEAMS, "a fixed chain has up to 4 beams, see BEAM_MAX_BEAMS");
+    static_assert(Mode == BEAM_CHAIN || Count == 1, "BEAM_SINGLE drives one beam");
 
-class Beam {
   public:
-    Beam(int rstpin, int irqpin, int numberOfBeams);
-    Beam(int rstpin, int irqpin, uint8_t syncMode, uint8_t beamAddress);
-    bool begin(void);
-    void initBeam();
-    void print(const char* text);
-    void printFrame(uint8_t frameToPrint, const char * text);
-    void play();
-    void draw();
-    void display(int frameNum);
-    void setScroll(uint8_t direction, uint8_t fade);
-    void setSpeed(uint8_t speed);
-    void setLoops (uint8_t loops);
-    void setMode (uint8_t mode);
-    void loadFrameFromRAM(int beam, uint8_t frameNum, uint8_t *pFrameData);
+    // templates only so that each is checked against Count where it is used
+    template <uint8_t Fixed = Count>
+    BeamChain(int rstpin, int irqpin, int numberOfBeams);
+    template <uint8_t Fixed = Count>
+    BeamChain(int rstpin, int irqpin, uint8_t syncMode, uint8_t beamAddress);
+    template <uint8_t Fixed = Count>
+    BeamChain(int rstpin, int irqpin, uint8_t numberOfBeams, const uint8_t *addresses, const uint8_t *channels = 0, uint8_t muxAddress = BEAM_MUX);
+    template <uint8_t Fixed = Count>
+    BeamChain(int rstpin, int irqpin);
+    ~BeamChain();
+    bool begin(void) { return start(BeamBuildLayout()); }
+    uint8_t initBeam();
+    void setSoftReplace(bool enable);
+    void setLowercase(bool enable);
+    uint8_t print(const char* text);
+    uint8_t printAsync(const char* text);
+    uint8_t printFrame(uint8_t frameToPrint, const char * text);
+    uint8_t printStatic(const char* text);
+    uint8_t printStaticAsync(const char* text);
+    uint8_t backFrame();
+    uint8_t flip();
+    uint8_t stream(BeamFrameSource source, uint8_t speed);
+    uint8_t marquee(const char* text, uint8_t speed);
+    bool streaming();
+    uint16_t streamUnderruns();
+    uint8_t play();
+    uint8_t playAsync();
+    uint8_t draw();
+    uint8_t drawAsync();
+    uint8_t poll(uint8_t maxTransactions = BEAM_POLL_TRANSACTIONS);
+    uint8_t display(int frameNum);
+    uint8_t setBrightness(uint16_t x, uint8_t y, uint8_t level);
+    uint8_t loadGrayFrame(int beam, const uint8_t *levels);
+    uint8_t setDimmer(uint8_t level);
+    uint8_t breathe(uint16_t periodMs);
+    uint8_t crossfade(const char* text, uint16_t durationMs);
+    uint8_t blink(uint16_t x0, uint8_t y0, uint16_t x1, uint8_t y1, uint16_t periodMs);
+    uint8_t stopEffect();
+    bool effectRunning();
+    void setEffectRate(uint8_t stepsPerSecond);
+    uint8_t setScroll(uint8_t direction, uint8_t fade);
+    uint8_t setSpeed(uint8_t speed);
+    uint8_t setLoops (uint8_t loops);
+    uint8_t setMode (uint8_t mode);
+    uint8_t loadFrameFromRAM(int beam, uint8_t frameNum, uint8_t *pFrameData);
     volatile int beamNumber;
     int checkStatus();
     int status();
+    BeamStats getStats();
+    void clearStats();
+    uint32_t busMicros(uint32_t clockHz);
+    bool dumpFrame(Print &out, int beam, uint8_t frameNum);
+    BeamTiming getTiming();
+    void clearTiming();
+    void setBusClock(uint32_t clockHz);
+    uint8_t lastError();
+    uint16_t errorCount(int beam);
+    bool beamOnline(int beam);
+    void clearErrors();
+    #if BEAM_INSTRUMENT
+    void getInstrument(BeamInstrument &snapshot);
+    void clearInstrument();
+    #endif
+    #if BEAM_TRACE
+    uint8_t drain(Print &out, uint8_t maxRecords = 4);
+    #endif
 
 
   private:
-    uint16_t cs[12], segmentmask[8];
-    uint8_t cscolumn[25];
-    uint8_t _gblMode, _currBeam, _syncMode, _lastFrameWrite, _scrollMode, _scrollDir, _fadeMode, _frameDelay, _beamMode, _numLoops;
+    BeamChain(int rstpin, int irqpin, uint8_t mode, uint8_t count, const uint8_t *addresses, uint8_t current);
+    static const uint8_t _chain[4];
+
+    // beams the per beam arrays have room for, and the tracked ones among them
+    static const uint8_t Slots = Count ? Count : BEAM_MAX_BEAMS;
+    static const uint8_t ShadowBeams = (BEAM_SHADOW_BEAMS < Slots) ? BEAM_SHADOW_BEAMS : Slots;
+    static const uint8_t GrayBeams = (BEAM_GRAY_BEAMS < Slots) ? BEAM_GRAY_BEAMS : Slots;
+    static const uint8_t StreamBeams = (BEAM_STREAM_BEAMS < Slots) ? BEAM_STREAM_BEAMS : Slots;
+
+    // Address of the n-th beam of a fixed chain
+    static constexpr uint8_t chainAddress(uint8_t n){
+        return (n == 0) ? BEAMA : (n == 1) ? BEAMB : (n == 2) ? BEAMC : BEAMD;
+    }
+
+    // LED current based on the number of connected beams
+    static constexpr uint8_t currentFor(uint8_t mode, uint8_t count){
+        return (mode != BEAM_CHAIN) ? 0x15 : (count >= 4) ? 0x08 : (count == 3) ? 0x10 : (count >= 1) ? 0x20 : 0x15;
+    }
+
+    bool start(BeamBuildLayout);
+    uint16_t cs[12];
+    uint8_t _gblMode, _syncMode, _lastFrameWrite, _scrollMode, _scrollDir, _fadeMode, _frameDelay, _beamMode, _numLoops;
     int _rst, _irq, _beamCount, activeBeams;
+    BeamStats _stats;
+    uint8_t _beamAddr[Slots];
+    uint8_t _beamChannel[Slots];
+    uint8_t _muxAddr, _muxChannel, _currentSource;
+    uint8_t _regsel[Slots];
+    uint8_t _offline[(Slots + 7) / 8];
+    uint16_t _beamErrors[Slots];
+    uint16_t _failures;
+    uint8_t _lastError;
+    uint32_t _busClock;
+    uint8_t result(uint16_t failures);
+    #if BEAM_TRACE
+    BeamTraceRecord _trace[BEAM_TRACE_RECORDS];
+    uint8_t _traceHead, _traceCount;
+    uint16_t _traceLost;
+    void traceEvent(uint8_t event, uint8_t beam, uint8_t frame, uint8_t data);
+    #endif
+    #if BEAM_INSTRUMENT
+    BeamInstrument _instrument;
+    uint8_t _api;
+    struct ApiScope {
+        BeamChain *beam;
+        bool outer;
+        unsigned long start;
+        ApiScope(BeamChain *b, uint8_t api);
+        ~ApiScope();
+    };
+    void instrument(uint8_t transactions, uint8_t bytes);
+    void phaseDone(BeamPhaseTiming &phase, unsigned long start);
+    #endif
+    bool retryAfter(uint8_t n, uint8_t stat, uint8_t attempt);
+    void recoverBus();
+    uint8_t transmit(uint8_t n, uint8_t address, uint8_t subreg, const uint8_t *data, uint8_t value, uint8_t len);
+    uint8_t _pwmReady[(Slots + 7) / 8];
+    uint8_t _grayValid[(Slots + 7) / 8];
+    uint8_t _dimmer;
+    bool _grayUsed;
+    #if BEAM_GRAY_BEAMS
+    uint8_t _gray[GrayBeams][120];
+    #endif
+    uint8_t grayValue(uint8_t level, uint8_t dimmer);
+    uint8_t ledValue(uint8_t n, uint8_t p, uint8_t level, uint8_t dimmer, bool hidden);
+    uint8_t *grayLevels(uint8_t n);
+    uint8_t writeGray(uint8_t n, const uint8_t *levels, uint8_t dimmer, bool hidden, bool full);
+    uint8_t _effect, _effectPhase, _effectBase;
+    uint16_t _effectPeriod, _effectInterval;
+    unsigned long _effectStart, _effectTimer;
+    const char *_effectText;
+    uint16_t _blinkX0, _blinkX1;
+    uint8_t _blinkY0, _blinkY1;
+    bool _blinkHidden;
+    void effectStep();
+    uint8_t _frontFrame;
+    bool _busFault, _configured, _softReplace, _lowercase;
+    // printStatic() settings are on the beams, PIC may have the picture bit set
+    bool _pictureMode, _picEnabled;
+    const char *_jobText;
+    uint8_t _jobState, _jobKind, _jobBeam, _jobItem, _jobCol, _startFrame;
+    bool _jobLast, _irqEnabled, _handOff;
+    volatile bool _irqFlag;
+    unsigned long _statusTimer, _irqTimeout;
+    static void irqHandler();
+    uint16_t _jobPos, _jobSteps, _jobTotal, _jobFrames;
+    unsigned long _jobTimer, _jobStart;
+    BeamTiming _timing;
+    uint8_t _frameDirty[ShadowBeams][(MAXFRAME + 7) / 8];
+    int beamSlot(uint8_t n);
+    bool staleFrame(uint8_t n, uint8_t f);
+    #if BEAM_SHADOW_FRAMES
+    uint8_t _shadow[ShadowBeams][BEAM_SHADOW_FRAMES][24];
+    uint8_t _shadowValid[ShadowBeams][(BEAM_SHADOW_FRAMES + 7) / 8];
+    #endif
 
+    uint8_t handOffBeam();
     void startNextBeam();
-    void initializeBeam(uint8_t b);
+    void armHandOff();
+    void initializeBeam(uint8_t n);
+    void initializeStep(uint8_t n, uint8_t item);
     void setPrintDefaults(uint8_t mode, uint8_t startFrame, uint8_t numFrames, uint8_t numLoops, uint8_t frameDelay, uint8_t scrollDir, uint8_t fadeMode);
-    void writeFrame(uint8_t addr, uint8_t f);
-    //void convertFrame(uint8_t * currentFrame);
-    void convertFrame(uint16_t currentFrame);
+    void loadPrintDefaults(uint8_t mode, uint8_t startFrame, uint8_t numFrames, uint8_t numLoops, uint8_t frameDelay, uint8_t scrollDir, uint8_t fadeMode);
+    void writePrintDefaults(uint8_t n);
+    void writeStaticDefaults(uint8_t n);
+    int findBeam(int beam);
+    void writeControl(uint8_t subreg, uint8_t data);
+
+    // How many beams the per beam loops have to cover
+    uint8_t beamTotal(){
+        return Count ? Count : _beamCount;
+    }
+
+    // BEAM_CHAIN or BEAM_SINGLE
+    uint8_t chainMode(){
+        return Count ? Mode : _gblMode;
+    }
+
+    // Address of the n-th beam in the chain, or the single beam
+    uint8_t beamAddress(uint8_t n){
+        return (Count && Mode == BEAM_CHAIN) ? chainAddress(n) : _beamAddr[n];
+    }
+
+    // Frame offset of the n-th beam, in a chain each beam runs one frame
+    // ahead of the beam to its left
+    uint8_t frameOffset(uint8_t n){
+        return beamTotal() - n;
+    }
+
+    // CURSRC setting, the LED current for the length of the chain
+    uint8_t currentSource(){
+        return Count ? currentFor(Mode, Count) : _currentSource;
+    }
+    uint8_t nextGlyph(const char *text, uint16_t &pos);
+    BeamFrameSource _streamSource;
+    uint32_t _streamNext, _streamShown, _streamEnd;
+    uint16_t _streamUnderruns;
+    #if BEAM_STREAM_BEAMS
+    uint8_t _streamLast[StreamBeams][15];
+    #endif
+    uint16_t _marqueePos[Slots];
+    uint8_t _marqueeCol[Slots];
+    void streamFrame(uint8_t n);
+    bool streamStep();
+    uint8_t startJob();
+    bool jobStep();
+    void startUpload();
+    void uploadStep();
+    bool renderFrame();
+    uint8_t packText(const char *text, uint16_t &pos, uint8_t &col);
+    void writeFrame(uint8_t n, uint8_t f);
+    void writeFrameData(uint8_t n, uint8_t f, const uint8_t *frameData);
     unsigned int setSyncTimer();
-    void sendWriteCmd(uint8_t addr, uint8_t ramsection, uint8_t subreg, uint8_t subregdata);
-    uint8_t sendReadCmd(uint8_t addr, uint8_t ramsection, uint8_t subreg);
-    uint8_t i2cwrite(uint8_t address, uint8_t cmdbyte, uint8_t databyte);
+    uint8_t sendWriteCmd(uint8_t n, uint8_t ramsection, uint8_t subreg, uint8_t subregdata);
+    uint8_t sendBurstCmd(uint8_t n, uint8_t ramsection, uint8_t subreg, const uint8_t *data, uint8_t len);
+    uint8_t sendReadCmd(uint8_t n, uint8_t ramsection, uint8_t subreg, uint8_t &value);
+    uint8_t i2cwrite(uint8_t n, uint8_t cmdbyte, uint8_t databyte);
+    uint8_t sendFillCmd(uint8_t n, uint8_t ramsection, uint8_t subreg, uint8_t value, uint8_t len);
+    uint8_t selectSection(uint8_t n, uint8_t ramsection);
+    uint8_t selectChannel(uint8_t n);
+    void resetBeams(int lowTime, int highTime);
+    void forgetBeams();
+    void busError(uint8_t n);
+    void invalidateSections();
+    void invalidateShadow();
     void convertFrameFromRAM(uint8_t *pFrameData);
 };
 
+typedef BeamChain<0, BEAM_CHAIN> Beam;
+
+//built once in beam.cpp
+extern template class BeamChain<0, BEAM_CHAIN>;
+
+#include "beamchain.h"
+
 
 #endif
\ No newline at end of file
@@ -0,0 +1,3083 @@
+/*
+===========================================================================
+
+  This is the library for Beam.
+
+  Beam is a beautiful LED matrix — features 120 LEDs that displays scrolling text, animations, or custom lighting effects.
+  Beam can be purchased here: http://www.hoverlabs.co
+
+  Written by Emran Mahbub and Jonathan Li for Hover Labs.
+  BSD license, all text above must be included in any redistribution
+
+===========================================================================
+*/
+
+/*
+    The engine behind Beam and BeamChain, included by beam.h. beam.cpp
+    builds it once for Beam, a chain fixed at compile time is built in the
+    sketch file that uses it.
+*/
+
+#ifndef _BEAMCHAIN
+#define _BEAMCHAIN
+
+#include "charactermap.h"
+#include "frames.h"
+
+// Wire's transmit buffer has to hold the sub register address plus the data,
+// so burst writes are split into chunks of BEAM_BURST_LENGTH data bytes
+#ifdef BUFFER_LENGTH
+#define BEAM_BURST_LENGTH (BUFFER_LENGTH - 1)
+#else
+#define BEAM_BURST_LENGTH 31
+#endif
+
+// states of the upload started by printAsync() and drawAsync()
+#define JOB_IDLE 0
+#define JOB_RESET 1
+#define JOB_RESET_LOW 2
+#define JOB_RESET_HIGH 3
+#define JOB_STOP 4
+#define JOB_INIT 5
+#define JOB_CLEAR 6
+#define JOB_RENDER 7
+#define JOB_DEFAULTS 8
+#define JOB_STREAM_START 9
+#define JOB_STREAMING 10
+
+#define JOB_PRINT 0
+#define JOB_DRAW 1
+#define JOB_STATIC 2
+// job kinds from JOB_STREAM on play from the frame ring, see stream()
+#define JOB_STREAM 3
+#define JOB_MARQUEE 4
+
+// effects run from poll(), see breathe(), crossfade() and blink()
+#define EFFECT_NONE 0
+#define EFFECT_BREATHE 1
+#define EFFECT_CROSSFADE 2
+#define EFFECT_BLINK 3
+
+#define FADE_OUT 0
+#define FADE_SWAP 1
+#define FADE_IN 2
+
+// records a trace event when tracing is compiled in, see drain()
+#if BEAM_TRACE
+static_assert((BEAM_TRACE_RECORDS & (BEAM_TRACE_RECORDS - 1)) == 0 && BEAM_TRACE_RECORDS <= 128, "BEAM_TRACE_RECORDS is a power of two up to 128");
+#define TRACE(event, beam, frame, data) traceEvent(event, beam, frame, data)
+#else
+#define TRACE(event, beam, frame, data)
+#endif
+
+// opens the instrumentation scope of a public call, see getInstrument()
+#if BEAM_INSTRUMENT
+#define BEAM_API(id) ApiScope apiScope(this, id)
+#else
+#define BEAM_API(id)
+#endif
+
+/*
+    Frame bitmaps are 5 rows of 3 bytes, one bit per column with the leftmost
+    column in bit 7. Each cs[] word holds two columns, the even column in
+    bits 0-4 and the odd column in bits 5-9 with row r at bit r, so a pair
+    of adjacent bits in a source byte lands in bits 0 and 5 of a word.
+    packFrame() reads every source byte once and shifts the looked up pair
+    into the four words it feeds, from the bottom row up. The frames of
+    draw() are encoded the same way at compile time, see frames.h.
+*/
+static const uint8_t pairBits[4] = {0x00, 0x20, 0x01, 0x21};
+
+struct RamSource {
+    const uint8_t *p;
+    RamSource(const uint8_t *data) : p(data) {}
+    uint8_t operator[](uint8_t i) const { return p[i]; }
+};
+
+template <class Source>
+static void packFrame(uint16_t *w, Source src){
+    for (uint8_t k=0; k<12; k++){
+        w[k] = 0;
+    }
+    for (int8_t r=4; r>=0; r--){
+        for (uint8_t c=0; c<3; c++){
+            uint8_t b = src[3*r + c];
+            uint16_t *q = w + 4*c;
+            q[0] = (q[0] << 1) | pairBits[b >> 6];
+            q[1] = (q[1] << 1) | pairBits[(b >> 4) & 3];
+            q[2] = (q[2] << 1) | pairBits[(b >> 2) & 3];
+            q[3] = (q[3] << 1) | pairBits[b & 3];
+        }
+    }
+}
+
+/*
+    Gray level to PWM value, gamma 2.2 so that equal steps in level look
+    like equal steps in brightness. Levels above 0 keep the LED lit.
+*/
+static const uint8_t gammaTable[256] PROGMEM = {
+    0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2,
+    3, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6,
+    6, 7, 7, 7, 8, 8, 8, 9, 9, 9, 10, 10, 11, 11, 11, 12,
+    12, 13, 13, 13, 14, 14, 15, 15, 16, 16, 17, 17, 18, 18, 19, 19,
+    20, 20, 21, 22, 22, 23, 23, 24, 25, 25, 26, 26, 27, 28, 28, 29,
+    30, 30, 31, 32, 33, 33, 34, 35, 35, 36, 37, 38, 39, 39, 40, 41,
+    42, 43, 43, 44, 45, 46, 47, 48, 49, 49, 50, 51, 52, 53, 54, 55,
+    56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71,
+    73, 74, 75, 76, 77, 78, 79, 81, 82, 83, 84, 85, 87, 88, 89, 90,
+    91, 93, 94, 95, 97, 98, 99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
+    113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
+    137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
+    163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
+    192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+    223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255
+};
+
+// config register, 36 blank frames and 6 blink/PWM sections
+#define INIT_ITEMS (1 + MAXFRAME + 6)
+
+template <uint8_t Count, uint8_t Mode>
+const uint8_t BeamChain<Count, Mode>::_chain[4] = {BEAMA, BEAMB, BEAMC, BEAMD};
+
+/*
+=================
+PUBLIC FUNCTIONS
+=================
+*/
+
+/*
+    This constructor used when multiple Beams behave like one long Beam
+*/
+template <uint8_t Count, uint8_t Mode>
+template <uint8_t Fixed>
+BeamChain<Count, Mode>::BeamChain ( int rstpin, int irqpin, int numberOfBeams)
+    : BeamChain(rstpin, irqpin, BEAM_CHAIN, (numberOfBeams >= 1 && numberOfBeams <= 4) ? numberOfBeams : 0, _chain, currentFor(BEAM_CHAIN, numberOfBeams)){
+    static_assert(Fixed == 0, "a fixed chain is constructed with BeamChain(rstpin, irqpin)");
+}
+
+/*
+    This constructor used for a chain fixed at compile time, see BeamChain
+*/
+template <uint8_t Count, uint8_t Mode>
+template <uint8_t Fixed>
+BeamChain<Count, Mode>::BeamChain ( int rstpin, int irqpin)
+    : BeamChain(rstpin, irqpin, Mode, Count, _chain, currentFor(Mode, Count)){
+    static_assert(Fixed != 0 && Mode == BEAM_CHAIN, "BeamChain(rstpin, irqpin) needs a Count, BEAM_SINGLE takes the address of its beam");
+}
+
+/*
+    This constructor used when multiple Beams behave like single Beam units
+*/
+template <uint8_t Count, uint8_t Mode>
+template <uint8_t Fixed>
+BeamChain<Count, Mode>::BeamChain ( int rstpin, int irqpin, uint8_t syncMode, uint8_t beamAddress)
+    : BeamChain(rstpin, irqpin, BEAM_SINGLE, 1, &beamAddress, currentFor(BEAM_SINGLE, 1)){
+    static_assert(Fixed == 0 || Mode == BEAM_SINGLE, "a fixed chain is constructed with BeamChain(rstpin, irqpin)");
+    _syncMode = 0;
+}
+
+/*
+    Chains numberOfBeams beams whose addresses are listed from left to
+    right. Beams can also sit behind a TCA9548A I2C
+    multiplexer at muxAddress, channels[n] then is the multiplexer channel
+    of the n-th beam or BEAM_NO_MUX for a beam on the main bus. Beams on
+    different channels may share an address, which lets a sign grow past
+    the four Beam addresses, for example:
+
+        const uint8_t addresses[8] = {BEAMA, BEAMB, BEAMC, BEAMD, BEAMA, BEAMB, BEAMC, BEAMD};
+        const uint8_t channels[8] = {0, 0, 0, 0, 1, 1, 1, 1};
+        Beam b = Beam(RSTPIN, IRQPIN, 8, addresses, channels);
+
+    Beams on the main bus must not share an address with beams behind the
+    multiplexer. The tables are copied, they do not have to stay valid.
+
+    A chain takes up to BEAM_MAX_BEAMS beams, 4 by default, so the example
+    needs BEAM_MAX_BEAMS raised to 8 in beam.h or as a build flag. A longer
+    table is not cut short: the chain is left without beams, begin()
+    returns false and the other calls return BEAM_ERR_ARGUMENT.
+*/
+template <uint8_t Count, uint8_t Mode>
+template <uint8_t Fixed>
+BeamChain<Count, Mode>::BeamChain ( int rstpin, int irqpin, uint8_t numberOfBeams, const uint8_t *addresses, const uint8_t *channels, uint8_t muxAddress)
+    : BeamChain(rstpin, irqpin, BEAM_CHAIN, numberOfBeams, addresses, currentFor(BEAM_CHAIN, numberOfBeams)){
+    static_assert(Fixed == 0, "address tables and multiplexers are for chains set up at run time");
+    _muxAddr = muxAddress;
+    for (uint8_t n=0; n<_beamCount; n++){
+        _beamChannel[n] = channels ? channels[n] : BEAM_NO_MUX;
+    }
+}
+
+/*
+    Every constructor ends up here. Whatever depends on the mode and the
+    length of the chain is worked out once when the object is constructed,
+    so the per beam loops only read _beamCount. A fixed chain does not read
+    it at all, see beamTotal().
+*/
+template <uint8_t Count, uint8_t Mode>
+BeamChain<Count, Mode>::BeamChain ( int rstpin, int irqpin, uint8_t mode, uint8_t count, const uint8_t *addresses, uint8_t current){
+    _rst = rstpin;
+    _irq = irqpin;
+    _gblMode = mode;
+    _currentSource = current;
+    _beamCount = (count >= 1 && count <= Slots) ? count : 0;
+    _muxAddr = BEAM_MUX;
+    for (uint8_t n=0; n<Slots; n++){
+        _beamAddr[n] = (n < _beamCount) ? addresses[n] : 0;
+        _beamChannel[n] = BEAM_NO_MUX;
+    }
+    activeBeams = _beamCount;
+    clearStats();
+    clearErrors();
+    #if BEAM_INSTRUMENT
+    _api = BEAM_API_OTHER;
+    clearInstrument();
+    #endif
+    #if BEAM_TRACE
+    _traceHead = 0;
+    _traceCount = 0;
+    _traceLost = 0;
+    #endif
+    _failures = 0;
+    _busClock = 0;
+    memset(_offline, 0, sizeof(_offline));
+    invalidateSections();
+    invalidateShadow();
+    memset(_pwmReady, 0, sizeof(_pwmReady));
+    memset(_grayValid, 0, sizeof(_grayValid));
+    #if BEAM_GRAY_BEAMS
+    memset(_gray, 0xFF, sizeof(_gray));
+    #endif
+    _grayUsed = false;
+    _dimmer = 255;
+    _effect = EFFECT_NONE;
+    _effectBase = 255;
+    _effectInterval = 1000 / 30;
+    _effectTimer = 0;
+    _blinkHidden = false;
+    _busFault = false;
+    _configured = false;
+    _pictureMode = false;
+    _picEnabled = false;
+    _softReplace = true;
+    _frontFrame = 0;
+    _streamSource = 0;
+    _lowercase = false;
+    _jobState = JOB_IDLE;
+    _irqEnabled = false;
+    _irqFlag = false;
+    _handOff = false;
+    clearTiming();
+}
+
+/*
+    Gives the IRQ back if this object owns it, so that the interrupt does
+    not reach a deleted Beam
+*/
+template <uint8_t Count, uint8_t Mode>
+BeamChain<Count, Mode>::~BeamChain(){
+    if (_irqOwner == this){
+        detachInterrupt(digitalPinToInterrupt(_irq));
+        _irqOwner = 0;
+    }
+}
+
+/*
+    Called by begin() in beam.h with the layout the sketch was built with,
+    see BeamLayout. Only one Beam at a time can use the IRQ pin: while
+    another object owns it, begin() leaves it alone and chained playback
+    polls the frame status instead, see checkStatus().
+*/
+template <uint8_t Count, uint8_t Mode>
+bool BeamChain<Count, Mode>::start(BeamBuildLayout){
+
+    BEAM_API(BEAM_API_BEGIN);
+
+    //nothing to drive, see the constructors
+    if (beamTotal() == 0){
+        return false;
+    }
+
+    //resets beam - will clear all beams
+    resetBeams(200, 350);
+
+    //a stuck transaction gives up instead of hanging, see BEAM_I2C_TIMEOUT
+    #if defined(WIRE_HAS_TIMEOUT)
+    Wire.setWireTimeout(BEAM_I2C_TIMEOUT, true);
+    #endif
+
+    //use the IRQ pin for chained playback when it can raise an interrupt
+    _irqEnabled = false;
+    if (_irq >= 0 && digitalPinToInterrupt(_irq) != NOT_AN_INTERRUPT && (_irqOwner == 0 || _irqOwner == this)){
+        pinMode(_irq, INPUT_PULLUP);
+        _irqOwner = this;
+        attachInterrupt(digitalPinToInterrupt(_irq), irqHandler, FALLING);
+        _irqEnabled = true;
+    }
+
+    //reset cs[]
+    int c = 0;
+    for (c=0; c<12; c++){
+        cs[c] = 0x00;
+    }
+
+    return true;
+
+}
+
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::initBeam(){
+
+    BEAM_API(BEAM_API_BEGIN);
+    uint16_t failures = _failures;
+
+    _timing.configMicros = 0;
+    _timing.framesMicros = 0;
+    _timing.pwmMicros = 0;
+
+    //initialize Beam
+    uint8_t beams = beamTotal();
+    for (uint8_t n=0; n<beams; n++){
+        initializeBeam(n);
+    }
+
+    #if DEBUG
+    if (beams == 0){
+        Serial.println("beamCount should be between 1 and BEAM_MAX_BEAMS");
+    }
+    #endif
+
+    _configured = !_busFault;
+    return result(failures);
+
+}
+
+/*
+    With soft replace on (the default) a new message does not reset the
+    beams: playback is stopped through SHDN and the controllers keep their
+    configuration, so only the frames of the new message need uploading.
+    The reset pin is only pulsed before the first message and after a bus
+    error.
+*/
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::setSoftReplace(bool enable){
+    _softReplace = enable;
+}
+
+/*
+    Lowercase letters are shown with the uppercase glyphs unless this is
+    turned on, Latin-1 letters without an uppercase glyph keep their own.
+*/
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::setLowercase(bool enable){
+    _lowercase = enable;
+}
+
+/*
+    Decodes the character at text[pos], plain ASCII or UTF-8, moves pos past
+    it and returns its glyph in the packed font, see charactermap.h.
+    Characters the font does not have get the fallback glyph.
+*/
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::nextGlyph(const char *text, uint16_t &pos){
+
+    uint32_t c = (uint8_t)text[pos++];
+
+    if (c >= 0xC0 && c < 0xF8){
+        uint8_t extra = (c >= 0xF0) ? 3 : (c >= 0xE0) ? 2 : 1;
+        c &= 0x3F >> extra;
+        while (extra > 0 && ((uint8_t)text[pos] & 0xC0) == 0x80){
+            c = (c << 6) | (text[pos++] & 0x3F);
+            extra--;
+        }
+        if (extra > 0){
+            return FONT_FALLBACK;
+        }
+    } else if (c >= 0x80){
+        return FONT_FALLBACK;
+    }
+
+    if (!_lowercase && c >= 'a' && c <= 'z'){
+        c -= 32;
+    }
+    if (c >= 32 && c <= 96){
+        return c - 32;
+    }
+    if (c >= 'a' && c <= 'z'){
+        return FONT_LOWER + (c - 'a');
+    }
+    if (c >= '{' && c <= '~'){
+        return FONT_BRACES + (c - '{');
+    }
+    if (c > 0xFF){
+        return FONT_FALLBACK;
+    }
+
+    // Latin-1 lowercase sits 0x20 above its uppercase letter
+    if (!_lowercase && c >= 0xE0 && c != 0xF7 && c != 0xFF){
+        for (uint8_t g=0; g<FONT_LATIN_COUNT; g++){
+            if (pgm_read_byte_near(&fontLatin[g]) == c - 0x20){
+                return FONT_LATIN + g;
+            }
+        }
+    }
+    for (uint8_t g=0; g<FONT_LATIN_COUNT; g++){
+        if (pgm_read_byte_near(&fontLatin[g]) == c){
+            return FONT_LATIN + g;
+        }
+    }
+    return FONT_FALLBACK;
+
+}
+
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::print(const char* text){
+
+    BEAM_API(BEAM_API_PRINT);
+    uint16_t failures = _failures;
+
+    uint8_t stat = printAsync(text);
+    if (stat != BEAM_OK){
+        return stat;
+    }
+    while (poll(255) < 100){
+    }
+
+    return result(failures);
+
+}
+
+/*
+    Starts uploading text to the beams and returns straight away. Call poll()
+    from loop() until it returns 100, the text is read while uploading so it
+    has to stay valid until then. Text beyond the 36 frames is cut off, see
+    marquee() for longer text.
+*/
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::printAsync(const char* text){
+
+    BEAM_API(BEAM_API_PRINT);
+    uint16_t failures = _failures;
+
+    _jobText = text;
+    _jobKind = JOB_PRINT;
+    if (startJob() != BEAM_OK){
+        return BEAM_ERR_ARGUMENT;
+    }
+    return result(failures);
+
+}
+
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::printStatic(const char* text){
+
+    BEAM_API(BEAM_API_PRINT_STATIC);
+    uint16_t failures = _failures;
+
+    uint8_t stat = printStaticAsync(text);
+    if (stat != BEAM_OK){
+        return stat;
+    }
+    while (poll(255) < 100){
+    }
+
+    return result(failures);
+
+}
+
+/*
+    Shows text without scrolling: each beam gets the next 24 columns of the
+    text in the front frame, see flip(), and is switched to picture mode,
+    anything beyond the last beam is cut off. Only one frame per beam is uploaded, and while
+    the beams stay in picture mode an update costs nothing but the frame
+    registers that changed. Call poll() until it returns 100, like after
+    printAsync().
+*/
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::printStaticAsync(const char* text){
+
+    BEAM_API(BEAM_API_PRINT_STATIC);
+    uint16_t failures = _failures;
+
+    _jobText = text;
+    _jobKind = JOB_STATIC;
+    if (startJob() != BEAM_OK){
+        return BEAM_ERR_ARGUMENT;
+    }
+    return result(failures);
+
+}
+
+/*
+    Plays an animation of any length by using the frame memory as a ring.
+    source(index, beam, frame) fills in frame index for the n-th beam as a
+    15 byte bitmap like the ones in frames.h and returns false once the
+    animation has ended, its last frame then stays on show. Each frame
+    lasts speed * 32.5 ms, call poll() from loop() often enough to keep
+    the upload ahead of playback, see streamUnderruns().
+*/
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::stream(BeamFrameSource source, uint8_t speed){
+
+    BEAM_API(BEAM_API_STREAM);
+    uint16_t failures = _failures;
+
+    if (!(speed >= 1 && speed <= 15)){
+        #if DEBUG
+        Serial.println("Enter a speed between 1 and 15");
+        #endif
+        return BEAM_ERR_ARGUMENT;
+    }
+    if (source == 0 || beamTotal() == 0){
+        return BEAM_ERR_ARGUMENT;
+    }
+
+    _streamSource = source;
+    _streamNext = 0;
+    _streamShown = 0;
+    _streamEnd = 0xFFFFFFFF;
+    _streamUnderruns = 0;
+    #if BEAM_STREAM_BEAMS
+    memset(_streamLast, 0, sizeof(_streamLast));
+    #endif
+
+    loadPrintDefaults(MOVIE, 0, MAXFRAME, 7, speed, 1, 0);
+    _jobKind = JOB_STREAM;
+    if (startJob() != BEAM_OK){
+        return BEAM_ERR_ARGUMENT;
+    }
+    return result(failures);
+
+}
+
+/*
+    Scrolls text of any length, unlike print() which stops after 36 frames.
+    The text is rendered a frame at a time into the frame ring of stream()
+    while it scrolls, so it has to stay valid until streaming() returns
+    false. Once the text has scrolled off the beams stay blank.
+*/
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::marquee(const char* text, uint8_t speed){
+
+    BEAM_API(BEAM_API_STREAM);
+    uint16_t failures = _failures;
+
+    if (!(speed >= 1 && speed <= 15)){
+        #if DEBUG
+        Serial.println("Enter a speed between 1 and 15");
+        #endif
+        return BEAM_ERR_ARGUMENT;
+    }
+    if (beamTotal() == 0){
+        return BEAM_ERR_ARGUMENT;
+    }
+
+    _jobText = text;
+    _streamNext = 0;
+    _streamShown = 0;
+    _streamEnd = 0xFFFFFFFF;
+    _streamUnderruns = 0;
+    memset(_marqueePos, 0, sizeof(_marqueePos));
+    memset(_marqueeCol, 0, sizeof(_marqueeCol));
+
+    loadPrintDefaults(SCROLL, 0, MAXFRAME, 7, speed, 1, 0);
+    _jobKind = JOB_MARQUEE;
+    if (startJob() != BEAM_OK){
+        return BEAM_ERR_ARGUMENT;
+    }
+    return result(failures);
+
+}
+
+template <uint8_t Count, uint8_t Mode>
+bool BeamChain<Count, Mode>::streaming(){
+    return _jobKind >= JOB_STREAM && _jobState != JOB_IDLE;
+}
+
+// how often playback caught up with frames that were not uploaded yet
+template <uint8_t Count, uint8_t Mode>
+uint16_t BeamChain<Count, Mode>::streamUnderruns(){
+    return _streamUnderruns;
+}
+
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::printFrame(uint8_t frameToPrint, const char * text){
+
+    BEAM_API(BEAM_API_PRINT_FRAME);
+    uint16_t failures = _failures;
+
+    int frame = frameToPrint;
+
+    uint16_t pos = 0;
+    uint8_t col = 0;
+
+    while (text[pos] != 0 && frame < 36){
+
+      // only frames that fill up are written, like before
+      if (packText(text, pos, col) < 24){
+          break;
+      }
+
+      //write cs[0-11] to as1130 with current frame number.
+      if(chainMode() == BEAM_SINGLE){
+        writeFrame(0,frame);
+        _lastFrameWrite = frame;
+      }
+
+      frame = frame + 1;    // go to next frame
+      _lastFrameWrite = frame;
+
+      // if a specific frame is specified, then return if that frame is done.
+      if (frameToPrint!=0 && frame > frameToPrint){
+          //defaults Beam to basic settings
+          setPrintDefaults(SCROLL, 0, _lastFrameWrite, 7, 15, 1, 1);
+          return result(failures);
+      }
+
+    }
+
+    return result(failures);
+
+}
+
+
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::play(){
+
+    BEAM_API(BEAM_API_PLAY);
+    uint16_t failures = _failures;
+
+    playAsync();
+    while (_handOff){
+        poll();
+    }
+
+    return result(failures);
+
+}
+
+/*
+    Starts playback and returns straight away. On chained beams the
+    remaining beams are started from poll(), see checkStatus().
+*/
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::playAsync(){
+
+    BEAM_API(BEAM_API_PLAY);
+    uint16_t failures = _failures;
+
+    if (beamTotal() == 0){
+        return BEAM_ERR_ARGUMENT;
+    }
+
+    if (chainMode() == BEAM_CHAIN){
+
+        //start playing beams depending on scroll direction
+        if (_scrollDir == LEFT){
+            TRACE(BEAM_EV_PLAY, beamTotal() - 1, BEAM_TRACE_NONE, 0);
+            sendWriteCmd(beamTotal() - 1, CTRL, SHDN, 0x03);
+        } else if (_scrollDir == RIGHT) {
+            TRACE(BEAM_EV_PLAY, 0, BEAM_TRACE_NONE, 0);
+            sendWriteCmd(0, CTRL, SHDN, 0x03);
+        }
+
+        if (beamTotal() > 1) {
+            activeBeams = beamTotal();
+            armHandOff();
+            _handOff = true;
+        }
+
+    } else {
+        //start playing current beam
+        TRACE(BEAM_EV_PLAY, 0, BEAM_TRACE_NONE, 0);
+        sendWriteCmd(0, CTRL, SHDN, 0x03);
+    }
+
+    return result(failures);
+
+}
+
+/*
+    Returns the beam whose hand-off frame is being waited for. Playback
+    starts at the right end of the chain and moves left when scrolling
+    LEFT, and starts at the left end and moves right when scrolling RIGHT.
+*/
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::handOffBeam(){
+
+    return (_scrollDir == RIGHT) ? beamTotal() - activeBeams : activeBeams - 1;
+
+}
+
+/*
+    Starts the beam after the one that just reached its hand-off frame, in
+    the scroll direction. Called from checkStatus(), never from the
+    interrupt handler since Wire cannot be used there.
+*/
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::startNextBeam(){
+
+    uint8_t watch = handOffBeam();
+    uint8_t next = (_scrollDir == RIGHT) ? watch + 1 : watch - 1;
+
+    TRACE(BEAM_EV_HANDOFF, next, BEAM_TRACE_NONE, 0);
+    sendWriteCmd(next, CTRL, SHDN, 0x03);
+
+    if (_irqEnabled){
+        // reading the interrupt status releases the IRQ line,
+        // then stop this beam from raising it again
+        uint8_t irqStatus;
+        sendReadCmd(watch, CTRL, IRQSTATUS, irqStatus);
+        sendWriteCmd(watch, CTRL, IRQMASK, 0x00);
+    }
+
+    activeBeams--;
+
+}
+
+/*
+    Points the IRQ of the beam being watched at its hand-off frame
+*/
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::armHandOff(){
+
+    uint8_t watch = handOffBeam();
+    uint8_t target = beamTotal() - activeBeams + 1;
+
+    _statusTimer = millis();
+    _irqTimeout = (unsigned long)setSyncTimer() * (target + 1);
+
+    if (_irqEnabled){
+        _irqFlag = false;
+        sendWriteCmd(watch, CTRL, IRQFRAME, target);
+        sendWriteCmd(watch, CTRL, IRQMASK, IRQ_MOVIE);
+        uint8_t irqStatus;
+        sendReadCmd(watch, CTRL, IRQSTATUS, irqStatus);
+    }
+
+}
+
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::irqHandler(){
+    // only the chain that attached this handler owns the IRQ
+    if (_irqOwner){
+        static_cast<BeamChain *>(_irqOwner)->_irqFlag = true;
+    }
+}
+
+
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::setScroll(uint8_t direction, uint8_t fade){
+
+    BEAM_API(BEAM_API_SETTINGS);
+    uint16_t failures = _failures;
+
+    if (!(direction == RIGHT || direction == LEFT)){
+        #if DEBUG
+        Serial.println("Select either LEFT or RIGHT for direction");
+        #endif
+        return BEAM_ERR_ARGUMENT;
+    }
+
+    _scrollDir = direction;
+    _fadeMode = fade;
+    _scrollMode = 1;
+
+    uint8_t frameData = _fadeMode << 7 | _scrollDir << 6 | 0 << 5 | _scrollMode << 4 | _frameDelay;
+
+    writeControl(FRAMETIME, frameData);
+    return result(failures);
+
+}
+
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::setSpeed (uint8_t speed){
+
+    BEAM_API(BEAM_API_SETTINGS);
+    uint16_t failures = _failures;
+
+    if (!(speed >= 1 && speed <= 15)){
+        #if DEBUG
+        Serial.println("Enter a speed between 1 and 15");
+        #endif
+        return BEAM_ERR_ARGUMENT;
+    }
+
+    if (_beamMode == MOVIE){
+        _scrollMode = 0;
+    } else {
+        _scrollMode = 1;
+    }
+
+    _frameDelay = speed;
+
+    uint8_t frameData = _fadeMode << 7 | _scrollDir << 6 | 0 << 5 | _scrollMode << 4 | _frameDelay;
+
+    writeControl(FRAMETIME, frameData);
+    return result(failures);
+
+}
+
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::setLoops (uint8_t loops){
+
+    BEAM_API(BEAM_API_SETTINGS);
+    uint16_t failures = _failures;
+
+    if (!(loops >= 1 && loops <= 7)){
+        #if DEBUG
+        Serial.println("Enter a speed between 1 and 7");
+        #endif
+        return BEAM_ERR_ARGUMENT;
+    }
+
+    _numLoops = loops;
+    uint8_t displayData = _numLoops << 5 | 0 << 4 | 0x0B;
+
+    writeControl(DISPLAYO, displayData);
+    return result(failures);
+
+}
+
+
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::setMode (uint8_t mode){
+
+    BEAM_API(BEAM_API_SETTINGS);
+    uint16_t failures = _failures;
+
+    if (!(mode == MOVIE || mode == SCROLL)){
+        #if DEBUG
+        Serial.println("Select either SCROLL or MOVIE for mode");
+        #endif
+        return BEAM_ERR_ARGUMENT;
+    }
+
+    _beamMode = mode;
+    uint8_t frameData = 0;
+
+    if (mode == MOVIE){
+        frameData = 0 << 7 | 0 << 6 | 0 << 5 | 0 << 4 | _frameDelay;
+    } else if (mode == SCROLL){
+        frameData = _fadeMode << 7 | _scrollDir << 6 | 0 << 5 | _scrollMode << 4 | _frameDelay;
+    }
+
+    writeControl(FRAMETIME, frameData);
+    return result(failures);
+
+}
+
+
+/*
+    Used by global mode to check when daisy chained Beams
+    should be activated depending on the scroll direction.
+    With a usable IRQ pin this only touches the bus once the watched beam
+    has raised its frame interrupt, otherwise (or when the interrupt is
+    overdue) the status register is polled every 10 ms.
+*/
+template <uint8_t Count, uint8_t Mode>
+int BeamChain<Count, Mode>::checkStatus(){
+
+    BEAM_API(BEAM_API_STATUS);
+
+    int frameDone = 0;
+    uint8_t beams = beamTotal();
+
+    if (chainMode() != BEAM_CHAIN || beams < 2 || activeBeams < 2){
+        return 0;
+    }
+
+    uint8_t watch = handOffBeam();
+    uint8_t target = beams - activeBeams + 1;
+    bool reached = false;
+
+    if (_irqEnabled && _irqFlag){
+        reached = true;
+    } else if (!_irqEnabled || millis() - _statusTimer >= _irqTimeout){
+        if (millis() - _statusTimer < 10 && !_irqEnabled){
+            return 0;
+        }
+        _statusTimer = millis();
+        _irqTimeout = 10;
+        // a beam that cannot be read is not waited for
+        uint8_t frameStatus;
+        uint8_t stat = sendReadCmd(watch, CTRL, 0x0F, frameStatus);
+        frameDone = frameStatus >> 2;
+        TRACE(BEAM_EV_STATUS, watch, frameDone, stat);
+        reached = (stat != 0 || frameDone >= target);
+    }
+
+    if (!reached){
+        return 0;
+    }
+
+    startNextBeam();
+
+    if (activeBeams == 1){
+        if (beams > 2){
+            delay(10);
+        }
+        activeBeams = beams;
+        _handOff = false;
+        return 1;
+    }
+
+    armHandOff();
+    return 0;
+
+}
+
+
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::draw(){
+
+    BEAM_API(BEAM_API_DRAW);
+    uint16_t failures = _failures;
+
+    uint8_t stat = drawAsync();
+    if (stat != BEAM_OK){
+        return stat;
+    }
+    while (poll(255) < 100){
+    }
+
+    return result(failures);
+
+}
+
+/*
+    Starts uploading the frames from frames.h and returns straight away,
+    see printAsync()
+*/
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::drawAsync(){
+
+    BEAM_API(BEAM_API_DRAW);
+    uint16_t failures = _failures;
+
+    _jobText = 0;
+    _jobKind = JOB_DRAW;
+    if (startJob() != BEAM_OK){
+        return BEAM_ERR_ARGUMENT;
+    }
+    return result(failures);
+
+}
+
+/*
+    Runs the upload started by printAsync() or drawAsync() for at most
+    maxTransactions I2C transactions (one step may overrun it by a few) and
+    returns the progress in percent, 100 once the upload is finished.
+*/
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::poll(uint8_t maxTransactions){
+
+    BEAM_API(BEAM_API_POLL);
+
+    uint32_t start = _stats.transactions;
+
+    if (_handOff){
+        checkStatus();
+    }
+
+    if (_effect != EFFECT_NONE && millis() - _effectTimer >= _effectInterval){
+        _effectTimer = millis();
+        effectStep();
+    }
+
+    bool busy = (_jobState != JOB_IDLE);
+    while (_jobState != JOB_IDLE && _stats.transactions - start < maxTransactions){
+        if (!jobStep()){
+            break;
+        }
+    }
+
+    if (_jobState == JOB_IDLE){
+        if (busy){
+            TRACE(BEAM_EV_JOB_DONE, BEAM_TRACE_NONE, BEAM_TRACE_NONE, _jobKind);
+        }
+        return 100;
+    }
+    if (_jobSteps >= _jobTotal){
+        return 99;
+    }
+    return (uint32_t)_jobSteps * 100 / _jobTotal;
+
+}
+
+/*
+    Double buffering for live graphics: frames 0 and 1 take turns as the
+    front frame on show and the back frame to draw into, for example with
+    loadFrameFromRAM(beam, backFrame(), data). flip() then shows what was
+    drawn without a half written frame ever being visible.
+*/
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::backFrame(){
+    return _frontFrame ^ 1;
+}
+
+/*
+    Shows the back frame on every beam, the old front frame becomes the new
+    back frame. The register selection is moved to the control registers
+    first, so the PIC writes go out back to back and the whole chain
+    switches within one frame time. The first flip also sets up picture
+    mode like printStatic().
+*/
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::flip(){
+
+    BEAM_API(BEAM_API_FLIP);
+    uint16_t failures = _failures;
+
+    uint8_t beams = beamTotal();
+    _frontFrame ^= 1;
+
+    if (!_pictureMode){
+        for (uint8_t n=0; n<=beams; n++){
+            writeStaticDefaults(n);
+        }
+        return result(failures);
+    }
+
+    for (uint8_t n=0; n<beams; n++){
+        selectSection(n, CTRL);
+    }
+    for (uint8_t n=0; n<beams; n++){
+        sendWriteCmd(n, CTRL, PIC, 0 << 7 | 1 << 6 | _frontFrame);
+    }
+
+    return result(failures);
+
+}
+
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::display(int frameNum){
+
+    BEAM_API(BEAM_API_SETTINGS);
+    uint16_t failures = _failures;
+
+      uint8_t pictureData = 0 << 7 | 1 << 6 | frameNum;
+      uint8_t displaydata = 0 << 7 | 0 << 6 | 0 << 5 | 0 << 4 | 0x0B;
+
+      _pictureMode = false;
+      _picEnabled = true;
+
+      writeControl(PIC, pictureData);
+      writeControl(DISPLAYO, displaydata);
+    return result(failures);
+}
+
+/*
+    Sets the gray level of one LED, x counts columns from the left end of
+    the chain and y rows from the top. Levels go from 0 to 255 and are
+    gamma corrected, they only show on LEDs that are lit in the frame on
+    show. Costs one register write, nothing when the level is unchanged.
+*/
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::setBrightness(uint16_t x, uint8_t y, uint8_t level){
+
+    BEAM_API(BEAM_API_GRAY);
+
+    uint8_t n = x / 24;
+    x = x % 24;
+    if (n >= beamTotal() || y >= 5){
+        return BEAM_ERR_ARGUMENT;
+    }
+
+    _grayUsed = true;
+    uint8_t *levels = grayLevels(n);
+    if (levels){
+        if (levels[24*y + x] == level && (_grayValid[n>>3] & (1 << (n & 7)))){
+            return BEAM_OK;
+        }
+        levels[24*y + x] = level;
+    }
+
+    // LED i of segment j sits at 11*j + i, see writeGray()
+    return sendWriteCmd(n, PWMSET, PWM_OFFSET + 11*(x/2) + y + 5*(x & 1), ledValue(n, 24*y + x, level, _dimmer, _blinkHidden));
+
+}
+
+/*
+    Sets the gray levels of every LED of a beam from 120 levels, 5 rows of
+    24 columns starting at the top left. Only the PWM registers whose
+    value changes are sent, in auto-increment bursts. beam is a position
+    in the chain or an address, see loadFrameFromRAM().
+*/
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::loadGrayFrame(int beam, const uint8_t *levels){
+
+    BEAM_API(BEAM_API_GRAY);
+    uint16_t failures = _failures;
+
+    int n = findBeam(beam);
+    if (n < 0){
+        return BEAM_ERR_ARGUMENT;
+    }
+
+    _grayUsed = true;
+    writeGray(n, levels, _dimmer, _blinkHidden, false);
+    return result(failures);
+
+}
+
+/*
+    Scales the gray level of every LED, 255 leaves them as set and 0 turns
+    everything off. On the first BEAM_GRAY_BEAMS beams the levels are kept
+    and only the PWM registers that change are rewritten. Other beams get
+    all their PWM registers rewritten as if every level were 255, which
+    replaces the levels set with setBrightness() or loadGrayFrame().
+*/
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::setDimmer(uint8_t level){
+
+    BEAM_API(BEAM_API_GRAY);
+    uint16_t failures = _failures;
+
+    _grayUsed = true;
+    for (uint8_t n=0; n<beamTotal(); n++){
+        writeGray(n, grayLevels(n), level, _blinkHidden, false);
+    }
+    _dimmer = level;
+    return result(failures);
+
+}
+
+/*
+    Lets the brightness of every beam rise and fall, one breath every
+    periodMs, until stopEffect(). Effects run from poll(), which has to be
+    called from loop() as often as the effect rate, see setEffectRate().
+    Each step only sends the PWM registers that change on beams whose
+    gray levels are kept, other beams get all of them, see setDimmer().
+*/
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::breathe(uint16_t periodMs){
+
+    BEAM_API(BEAM_API_EFFECT);
+    uint16_t failures = _failures;
+
+    stopEffect();
+    _grayUsed = true;
+    _effect = EFFECT_BREATHE;
+    _effectPeriod = periodMs ? periodMs : 1;
+    _effectStart = millis();
+    return result(failures);
+
+}
+
+/*
+    Replaces the message with text shown like printStatic(), fading the old
+    message out and the new one in over durationMs in total. text has to
+    stay valid until effectRunning() returns false.
+*/
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::crossfade(const char* text, uint16_t durationMs){
+
+    BEAM_API(BEAM_API_EFFECT);
+    uint16_t failures = _failures;
+
+    stopEffect();
+    _grayUsed = true;
+    _effect = EFFECT_CROSSFADE;
+    _effectText = text;
+    _effectPeriod = durationMs / 2 ? durationMs / 2 : 1;
+    _effectPhase = FADE_OUT;
+    _effectStart = millis();
+    return result(failures);
+
+}
+
+/*
+    Blinks the LEDs from column x0 to x1 and row y0 to y1, columns counted
+    from the left end of the chain, every periodMs until stopEffect(). Only
+    the PWM registers of the region are rewritten, the rest of the display
+    and its gray levels stay as they are. Beams whose gray levels are not
+    kept get all their PWM registers rewritten, only those the region
+    reaches.
+*/
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::blink(uint16_t x0, uint8_t y0, uint16_t x1, uint8_t y1, uint16_t periodMs){
+
+    BEAM_API(BEAM_API_EFFECT);
+    uint16_t failures = _failures;
+
+    stopEffect();
+    _blinkX0 = x0;
+    _blinkY0 = y0;
+    _blinkX1 = x1;
+    _blinkY1 = y1;
+    _grayUsed = true;
+    _effect = EFFECT_BLINK;
+    _effectPeriod = periodMs ? periodMs : 1;
+    _effectStart = millis();
+    return result(failures);
+
+}
+
+/*
+    Ends the running effect and brings the display back to the dimmer and
+    gray levels it had before, a crossfade still jumps to its new message.
+*/
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::stopEffect(){
+
+    BEAM_API(BEAM_API_EFFECT);
+    uint16_t failures = _failures;
+
+    if (_effect == EFFECT_CROSSFADE && _effectPhase == FADE_OUT){
+        printStaticAsync(_effectText);
+    }
+    if (_effect != EFFECT_NONE){
+        _effect = EFFECT_NONE;
+        for (uint8_t n=0; n<beamTotal(); n++){
+            writeGray(n, grayLevels(n), _effectBase, false, false);
+        }
+        _dimmer = _effectBase;
+        _blinkHidden = false;
+    }
+    _effectBase = _dimmer;
+    return result(failures);
+
+}
+
+template <uint8_t Count, uint8_t Mode>
+bool BeamChain<Count, Mode>::effectRunning(){
+    return _effect != EFFECT_NONE;
+}
+
+// how many effect steps poll() aims for per second, 30 by default
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::setEffectRate(uint8_t stepsPerSecond){
+    _effectInterval = 1000 / (stepsPerSecond ? stepsPerSecond : 1);
+}
+
+/*
+    Returns the frame a single beam is showing, or -1 in chain mode and
+    when the beam cannot be read.
+*/
+template <uint8_t Count, uint8_t Mode>
+int BeamChain<Count, Mode>::status(){
+
+    BEAM_API(BEAM_API_STATUS);
+
+    int frameDone = -1;
+
+    if (chainMode() == BEAM_SINGLE){
+        uint8_t frameStatus;
+        uint8_t stat = sendReadCmd(0, CTRL, 0x0F, frameStatus);
+        if (stat == 0){
+            frameDone = frameStatus >> 2;
+        }
+        TRACE(BEAM_EV_STATUS, 0, frameStatus >> 2, stat);
+    }
+    return frameDone;
+
+}
+
+/*
+    Returns the I2C transactions and bytes sent since the last clearStats()
+*/
+template <uint8_t Count, uint8_t Mode>
+BeamStats BeamChain<Count, Mode>::getStats(){
+    return _stats;
+}
+
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::clearStats(){
+    _stats.transactions = 0;
+    _stats.bytes = 0;
+    _stats.regselHits = 0;
+    _stats.regselMisses = 0;
+    _stats.errors = 0;
+    _stats.recoveries = 0;
+}
+
+/*
+    Estimates the time the counted traffic keeps the bus busy at the given
+    I2C clock: start, address byte and stop per transaction plus nine
+    clocks per byte. The clock counts in whole kHz, below 1 kHz there is
+    no estimate and 0 is returned.
+*/
+template <uint8_t Count, uint8_t Mode>
+uint32_t BeamChain<Count, Mode>::busMicros(uint32_t clockHz){
+    uint32_t kHz = clockHz / 1000UL;
+    if (kHz == 0){
+        return 0;
+    }
+    // 32 bit math, AVR cores pull in large routines for 64 bit division
+    uint32_t bits = _stats.transactions * (9 + 2) + _stats.bytes * 9;
+    if (bits <= 0xFFFFFFFFUL / 1000UL){
+        return bits * 1000UL / kHz;
+    }
+    return bits / kHz * 1000UL;
+}
+
+/*
+    Prints a frame as the beam shows it, from the shadow kept by writeFrame.
+    Returns false when the frame is not shadowed.
+*/
+template <uint8_t Count, uint8_t Mode>
+bool BeamChain<Count, Mode>::dumpFrame(Print &out, int beam, uint8_t frameNum){
+
+    int n = findBeam(beam);
+    if (n < 0){
+        return false;
+    }
+
+    #if BEAM_SHADOW_FRAMES
+    int slot = beamSlot(n);
+    if (slot >= 0 && frameNum < BEAM_SHADOW_FRAMES && (_shadowValid[slot][frameNum>>3] & (1 << (frameNum & 7)))){
+        uint8_t *shadow = _shadow[slot][frameNum];
+        for (int y=0; y<5; y++){
+            for (int x=0; x<24; x++){
+                uint16_t w = shadow[x & 0xFE] | (shadow[(x & 0xFE) + 1] << 8);
+                out.print((w >> (y + 5 * (x & 1))) & 1 ? '#' : '.');
+            }
+            out.println();
+        }
+        return true;
+    }
+    #endif
+
+    return false;
+
+}
+
+/*
+    Returns how long the last reset pulse and initBeam() phases took
+*/
+template <uint8_t Count, uint8_t Mode>
+BeamTiming BeamChain<Count, Mode>::getTiming(){
+    return _timing;
+}
+
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::clearTiming(){
+    _timing.resetMicros = 0;
+    _timing.configMicros = 0;
+    _timing.framesMicros = 0;
+    _timing.pwmMicros = 0;
+}
+
+/*
+    Sets the I2C clock. Use it instead of Wire.setClock(), a bus recovery
+    restarts Wire and this clock is set again afterwards.
+*/
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::setBusClock(uint32_t clockHz){
+    _busClock = clockHz;
+    Wire.setClock(clockHz);
+}
+
+/*
+    Returns the status of the last transaction that failed on every
+    attempt, BEAM_OK when there was none since clearErrors(), or
+    BEAM_ERR_OFFLINE when only offline beams were skipped since. Useful
+    after poll(), which reports progress instead of a status.
+*/
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::lastError(){
+    return _lastError;
+}
+
+/*
+    Returns how many I2C attempts failed on a beam since clearErrors(),
+    retries included, for spotting units that are about to fail. beam is a
+    position in the chain or an address, see loadFrameFromRAM().
+*/
+template <uint8_t Count, uint8_t Mode>
+uint16_t BeamChain<Count, Mode>::errorCount(int beam){
+    int n = findBeam(beam);
+    return (n < 0) ? 0 : _beamErrors[n];
+}
+
+/*
+    Returns false for a beam that has been skipped since a transaction
+    failed on it, until the next reset brings it back.
+*/
+template <uint8_t Count, uint8_t Mode>
+bool BeamChain<Count, Mode>::beamOnline(int beam){
+    int n = findBeam(beam);
+    return n >= 0 && !(_offline[n>>3] & (1 << (n & 7)));
+}
+
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::clearErrors(){
+    memset(_beamErrors, 0, sizeof(_beamErrors));
+    _lastError = BEAM_OK;
+}
+
+#if BEAM_INSTRUMENT
+/*
+    Copies the instrumentation into snapshot. Each BEAM_API_ entry holds
+    what its calls cost, including the poll() loop of the blocking calls;
+    work that poll() does for an async call counts under BEAM_API_POLL.
+    The phases time rendering text into columns, converting columns and
+    bitmaps into register images and uploading register images.
+*/
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::getInstrument(BeamInstrument &snapshot){
+    snapshot = _instrument;
+}
+
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::clearInstrument(){
+    memset(&_instrument, 0, sizeof(_instrument));
+}
+#endif
+
+#if BEAM_TRACE
+/*
+    Prints up to maxRecords of the oldest trace records, one line each:
+
+        trace,<micros>,<event>,<beam>,<frame>,<data>
+
+    see BEAM_EV_ for the events, 255 stands for no beam or frame. When the
+    ring ran over since the last drain a "trace,lost,<records>" line comes
+    first. Recording never waits for the output, so call this from loop()
+    with a count the output keeps up with. Returns the records still
+    waiting.
+*/
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::drain(Print &out, uint8_t maxRecords){
+
+    if (_traceLost){
+        out.print("trace,lost,");
+        out.println(_traceLost);
+        _traceLost = 0;
+    }
+
+    while (maxRecords > 0 && _traceCount > 0){
+        BeamTraceRecord r = _trace[(_traceHead - _traceCount) & (BEAM_TRACE_RECORDS - 1)];
+        _traceCount--;
+        maxRecords--;
+
+        out.print("trace,");
+        out.print(r.micros);
+        out.print(",");
+        out.print(r.event);
+        out.print(",");
+        out.print(r.beam);
+        out.print(",");
+        out.print(r.frame);
+        out.print(",");
+        out.println(r.data);
+    }
+    return _traceCount;
+
+}
+#endif
+
+
+/*
+=================
+PRIVATE FUNCTIONS
+=================
+*/
+
+/*
+    Status for a public call that started when _failures was failures: the
+    last failure if a transaction failed during the call, BEAM_OK if not.
+    A chain the constructor could not take has no beams and every call
+    returns BEAM_ERR_ARGUMENT.
+*/
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::result(uint16_t failures){
+    if (beamTotal() == 0){
+        return BEAM_ERR_ARGUMENT;
+    }
+    return (_failures != failures) ? _lastError : BEAM_OK;
+}
+
+#if BEAM_TRACE
+/*
+    Stores a trace record in constant time. A full ring drops its oldest
+    record, the newest ones are what a field issue needs.
+*/
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::traceEvent(uint8_t event, uint8_t beam, uint8_t frame, uint8_t data){
+
+    BeamTraceRecord &r = _trace[_traceHead];
+    r.event = event;
+    r.beam = beam;
+    r.frame = frame;
+    r.data = data;
+    r.micros = micros();
+
+    _traceHead = (_traceHead + 1) & (BEAM_TRACE_RECORDS - 1);
+    if (_traceCount < BEAM_TRACE_RECORDS){
+        _traceCount++;
+    } else if (_traceLost < 0xFFFF){
+        _traceLost++;
+    }
+
+}
+#endif
+
+#if BEAM_INSTRUMENT
+/*
+    Makes the outermost public call the one that is charged, so the
+    printAsync() and poll() calls inside print() count as print().
+*/
+template <uint8_t Count, uint8_t Mode>
+BeamChain<Count, Mode>::ApiScope::ApiScope(BeamChain *b, uint8_t api){
+    beam = b;
+    outer = (b->_api == BEAM_API_OTHER);
+    if (outer){
+        b->_api = api;
+        b->_instrument.api[api].calls++;
+        start = micros();
+    }
+}
+
+template <uint8_t Count, uint8_t Mode>
+BeamChain<Count, Mode>::ApiScope::~ApiScope(){
+    if (outer){
+        beam->_instrument.api[beam->_api].micros += micros() - start;
+        beam->_api = BEAM_API_OTHER;
+    }
+}
+
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::instrument(uint8_t transactions, uint8_t bytes){
+    _instrument.api[_api].transactions += transactions;
+    _instrument.api[_api].bytes += bytes;
+}
+
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::phaseDone(BeamPhaseTiming &phase, unsigned long start){
+    uint32_t t = micros() - start;
+    phase.count++;
+    phase.micros += t;
+    if (t > phase.maxMicros){
+        phase.maxMicros = t;
+    }
+}
+#endif
+
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::initializeBeam(uint8_t n){
+
+    for (uint8_t item=0; item<INIT_ITEMS; item++){
+        initializeStep(n, item);
+    }
+
+}
+
+/*
+    One step of initializeBeam: item 0 sets the config register, items 1 to
+    36 blank a frame and the last six fill one blink/PWM section each.
+*/
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::initializeStep(uint8_t n, uint8_t item){
+
+    unsigned long t = micros();
+
+    if (item == 0){
+        //set basic config on each defined beam unit
+        TRACE(BEAM_EV_INIT, n, BEAM_TRACE_NONE, 0);
+        sendWriteCmd(n, CTRL, CFG, 0x01);
+        _timing.configMicros += micros() - t;
+
+    } else if (item <= MAXFRAME){
+        //set each frame to off
+        for (int z=0; z<12; z++){
+            cs[z] = 0x00;
+        }
+        writeFrame(n, item - 1);
+        _timing.framesMicros += micros() - t;
+
+    } else {
+        //set basic blink + pwm registers for each defined beam,
+        //skipped when they have not been touched since the last init
+        uint8_t section = 0x40 + item - MAXFRAME - 1;
+        if (!(_pwmReady[n>>3] & (1 << (n & 7)))){
+            uint8_t stat = 0;
+            stat |= sendFillCmd(n, section, 0x00, 0x00, 0x18);
+            if (section == PWMSET && _grayUsed){
+                // the frames use the first set, it gets the gray levels
+                stat |= writeGray(n, grayLevels(n), _dimmer, _blinkHidden, true);
+            } else {
+                stat |= sendFillCmd(n, section, PWM_OFFSET, 0xFF, 0x9c - PWM_OFFSET);
+                // full brightness is what untouched gray levels give
+                if (section == PWMSET && stat == 0 && !_grayUsed){
+                    _grayValid[n>>3] |= (1 << (n & 7));
+                }
+            }
+            if (stat == 0 && !_busFault && section == 0x45){
+                _pwmReady[n>>3] |= (1 << (n & 7));
+            }
+        }
+        _timing.pwmMicros += micros() - t;
+    }
+
+}
+
+
+
+
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::setPrintDefaults (uint8_t mode, uint8_t startFrame, uint8_t numFrames, uint8_t numLoops, uint8_t frameDelay, uint8_t scrollDir, uint8_t fadeMode){
+
+    loadPrintDefaults(mode, startFrame, numFrames, numLoops, frameDelay, scrollDir, fadeMode);
+
+    for (uint8_t n=0; n<=beamTotal(); n++){
+        writePrintDefaults(n);
+    }
+
+}
+
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::loadPrintDefaults (uint8_t mode, uint8_t startFrame, uint8_t numFrames, uint8_t numLoops, uint8_t frameDelay, uint8_t scrollDir, uint8_t fadeMode){
+
+  _scrollMode = 1;
+  _scrollDir = scrollDir;
+  _fadeMode = fadeMode;
+  _frameDelay = frameDelay;
+  _beamMode = mode;
+  _numLoops = numLoops;
+  _startFrame = startFrame;
+
+}
+
+/*
+    Switches the n-th beam to show the front frame as a picture, skipped
+    while the beams are still in picture mode from printStatic() or flip()
+*/
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::writeStaticDefaults(uint8_t n){
+
+    if (n >= beamTotal()){
+        _pictureMode = !_busFault;
+        return;
+    }
+    if (_pictureMode){
+        return;
+    }
+
+    sendWriteCmd(n, CTRL, MOV, 0x00);
+    sendWriteCmd(n, CTRL, PIC, 0 << 7 | 1 << 6 | _frontFrame);
+    _picEnabled = true;
+    sendWriteCmd(n, CTRL, CURSRC, currentSource());
+    sendWriteCmd(n, CTRL, DISPLAYO, 0 << 7 | 0 << 6 | 0 << 5 | 0 << 4 | 0x0B);
+    sendWriteCmd(n, CTRL, SHDN, 0x03);
+
+}
+
+/*
+    Writes the settings from loadPrintDefaults() to the n-th beam, n equal
+    to the number of beams writes the clock sync settings of the chain
+*/
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::writePrintDefaults (uint8_t n){
+
+ // leave the picture shown by printStatic(), flip() or display()
+ if (_picEnabled && n < beamTotal()){
+    sendWriteCmd(n, CTRL, PIC, 0x00);
+ } else if (n >= beamTotal()){
+    _pictureMode = false;
+    _picEnabled = false;
+ }
+
+ if (_beamMode == MOVIE || _beamMode == SCROLL) {
+
+    //make sure startFrame between 0 and 35
+    //make sure numFrames between 2 and 36
+    //make sure frameDelay between 0 and 1111
+    //make sure numLoops between 000 and 111
+
+    if (n < beamTotal()){
+
+        if (chainMode() == BEAM_CHAIN && _scrollDir == RIGHT) {
+            //NEED TO MODIFY  FOR RIGHT OR LEFT SCROLL//
+            return;
+        }
+
+        uint8_t movieData =  0 << 7 | 1 << 6 | _startFrame;
+        uint8_t moviemodeData = 0 << 7 | 0 << 6 | _lastFrameWrite;
+        uint8_t frameData = 0;
+
+        switch (_beamMode) {
+          case MOVIE:
+            frameData = 0 << 7 | 0 << 6 | 0 << 5 | 0 << 4 | _frameDelay;
+            break;
+          case SCROLL:
+            frameData = _fadeMode << 7 | _scrollDir << 6 | 0 << 5 | _scrollMode << 4 | _frameDelay;
+            break;
+        }
+
+        uint8_t displayData = _numLoops << 5 | 0 << 4 | 0x0B;
+        uint8_t currsrcData = currentSource();
+
+        sendWriteCmd(n, CTRL, MOV, movieData );
+        sendWriteCmd(n, CTRL, MOVMODE, moviemodeData);
+        sendWriteCmd(n, CTRL, CURSRC, currsrcData);
+        sendWriteCmd(n, CTRL, FRAMETIME, frameData);
+        sendWriteCmd(n, CTRL, DISPLAYO, displayData);
+        sendWriteCmd(n, CTRL, SHDN, 0x02);
+
+    } else if (chainMode() == BEAM_CHAIN && beamTotal() >= 2){
+
+        /* define clk sync in/out settings based on left/right scrolling direction,
+           the beam that starts first drives the clock of the others */
+        uint8_t master = (_scrollDir == LEFT) ? beamTotal() - 1 : 0;
+        sendWriteCmd(master, CTRL, CLKSYNC, 0x02);
+        for (uint8_t b=0; b<beamTotal(); b++){
+            if (b != master){
+                sendWriteCmd(b, CTRL, CLKSYNC, 0x01);
+            }
+        }
+    }
+  }
+}
+
+
+
+template <uint8_t Count, uint8_t Mode>
+unsigned int BeamChain<Count, Mode>::setSyncTimer(){
+
+  unsigned int timeDelay = 0;
+
+  switch (_frameDelay){
+    case 1:
+      timeDelay = 32.5;
+    break;
+    case 2:
+      timeDelay = 65;
+    break;
+    case 3:
+      timeDelay = 97.5;
+    break;
+    case 4:
+      timeDelay = 130;
+    break;
+    case 5:
+      timeDelay = 162.5;
+    break;
+    case 6:
+      timeDelay = 195;
+    break;
+    case 7:
+      timeDelay = 227.5;
+    break;
+    case 8:
+      timeDelay = 260;
+    break;
+    case 9:
+      timeDelay = 292.5;
+    break;
+    case 10:
+      timeDelay = 325;
+    break;
+    case 11:
+      timeDelay = 357.5;
+    break;
+    case 12:
+      timeDelay = 390;
+    break;
+    case 13:
+      timeDelay = 422.5;
+    break;
+    case 14:
+      timeDelay = 455;
+    break;
+    case 15:
+      timeDelay = 487.5;
+    break;
+    default:
+      timeDelay = 10000;
+    break;
+    }
+    return timeDelay;
+
+}
+
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::writeFrame(uint8_t n, uint8_t f){
+
+    uint8_t frameData[24];
+    #if BEAM_INSTRUMENT
+    unsigned long t = micros();
+    #endif
+
+    for (int j=0x00; j<=0x0B; j++)
+    {
+        frameData[2*j]   = cs[j]&0xFF;          // frame register address (even numbers) then first data byte
+        frameData[2*j+1] = (cs[j]&0x300)>>8;    // frame register address (odd numbers) then second data byte
+    }
+
+    #if BEAM_INSTRUMENT
+    phaseDone(_instrument.convert, t);
+    t = micros();
+    #endif
+    writeFrameData(n, f, frameData);
+    #if BEAM_INSTRUMENT
+    phaseDone(_instrument.upload, t);
+    #endif
+}
+
+// write a 24 byte register image to frame f
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::writeFrameData(uint8_t n, uint8_t f, const uint8_t *frameData){
+
+    uint8_t p = f;
+
+    int slot = beamSlot(n);
+
+    // remember which frames hold anything but blank columns
+    if (slot >= 0 && p < MAXFRAME){
+        bool blank = true;
+        for (int j=0; j<24; j++){
+            if (frameData[j] != 0){
+                blank = false;
+                break;
+            }
+        }
+        if (blank){
+            _frameDirty[slot][p>>3] &= ~(1 << (p & 7));
+        } else {
+            _frameDirty[slot][p>>3] |= (1 << (p & 7));
+        }
+    }
+
+    #if BEAM_SHADOW_FRAMES
+    if (slot >= 0 && p < BEAM_SHADOW_FRAMES){
+
+        uint8_t *shadow = _shadow[slot][p];
+        uint8_t stat = 0;
+
+        // collect the runs of register pairs that differ from what the beam already
+        // holds, pairs separated by a single unchanged pair share a burst
+        uint8_t runFirst[6], runLast[6];
+        int runs = 0;
+        int cost = 0;
+
+        if (_shadowValid[slot][p>>3] & (1 << (p & 7))){
+            int j = 0;
+            while (j < 12){
+                if (shadow[2*j] == frameData[2*j] && shadow[2*j+1] == frameData[2*j+1]){
+                    j++;
+                    continue;
+                }
+                int last = j;
+                runFirst[runs] = j;
+                for (j=j+1; j<12 && j<=last+2; j++){
+                    if (shadow[2*j] != frameData[2*j] || shadow[2*j+1] != frameData[2*j+1]){
+                        last = j;
+                    }
+                }
+                runLast[runs] = last;
+                cost += 2 + 2*(last-runFirst[runs]+1);
+                runs++;
+                j = last + 1;
+            }
+        } else {
+            cost = 255;
+        }
+
+        if (cost >= 2 + 24){
+            TRACE(BEAM_EV_FRAME, n, p, 24);
+            stat = sendBurstCmd(n, p+1, 0x00, frameData, 24);
+        } else {
+            TRACE(BEAM_EV_FRAME, n, p, cost - 2*runs);
+            for (int r=0; r<runs; r++){
+                stat |= sendBurstCmd(n, p+1, 2*runFirst[r], &frameData[2*runFirst[r]], 2*(runLast[r]-runFirst[r]+1));
+            }
+        }
+
+        if (stat == 0){
+            memcpy(shadow, frameData, 24);
+            _shadowValid[slot][p>>3] |= (1 << (p & 7));
+        } else {
+            _shadowValid[slot][p>>3] &= ~(1 << (p & 7));
+            _frameDirty[slot][p>>3] |= (1 << (p & 7));
+        }
+        return;
+    }
+    #endif
+
+    // select the frame once and let the AS1130 auto-increment through all 24 registers
+    TRACE(BEAM_EV_FRAME, n, p, 24);
+    if (sendBurstCmd(n, p+1, 0x00, frameData, 24) != 0 && slot >= 0 && p < MAXFRAME){
+        _frameDirty[slot][p>>3] |= (1 << (p & 7));
+    }
+}
+
+
+// PWM value of a gray level after the dimmer and gamma correction
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::grayValue(uint8_t level, uint8_t dimmer){
+    return pgm_read_byte_near(&gammaTable[(level * dimmer + 127) / 255]);
+}
+
+// the gray levels kept for the n-th beam, 0 when they are not kept
+template <uint8_t Count, uint8_t Mode>
+uint8_t *BeamChain<Count, Mode>::grayLevels(uint8_t n){
+    #if BEAM_GRAY_BEAMS
+    if (n < GrayBeams){
+        return _gray[n];
+    }
+    #endif
+    return 0;
+}
+
+/*
+    PWM value of LED p (24*row + column) of the n-th beam, LEDs inside the
+    blink region are off while it is hidden
+*/
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::ledValue(uint8_t n, uint8_t p, uint8_t level, uint8_t dimmer, bool hidden){
+
+    if (hidden){
+        uint16_t x = 24*n + p % 24;
+        uint8_t y = p / 24;
+        if (x >= _blinkX0 && x <= _blinkX1 && y >= _blinkY0 && y <= _blinkY1){
+            return 0;
+        }
+    }
+    return grayValue(level, dimmer);
+
+}
+
+/*
+    Writes the PWM registers of the n-th beam for the given gray levels,
+    dimmer and blink state. The set holds 11 LEDs for each of the 12 segments, LED i of
+    segment j at 11*j + i, and bits 0-4 of a cs[] word are LEDs 0-4 of its
+    segment, so column x and row y land on LED y + 5*(x&1) of segment x/2.
+    Unless full is set only the registers that differ from what the kept
+    levels, the current dimmer and blink state gave are sent, runs separated by up to
+    two unchanged registers share a burst. The kept levels are updated.
+    Without levels every LED is at level 255, beams whose levels are not
+    kept always get all their registers.
+*/
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::writeGray(uint8_t n, const uint8_t *levels, uint8_t dimmer, bool hidden, bool full){
+
+    uint8_t *kept = grayLevels(n);
+    bool known = kept && !full && (_grayValid[n>>3] & (1 << (n & 7)));
+
+    uint8_t pwm[132];
+    int16_t first = -1, last = -1;
+    uint8_t stat = 0;
+    #if BEAM_INSTRUMENT
+    unsigned long t = micros();
+    #endif
+
+    for (uint8_t r=0; r<=132; r++){
+        bool changed = false;
+        if (r < 132){
+            uint8_t i = r % 11;
+            pwm[r] = 0xFF;
+            if (i < 10){
+                uint8_t p = 24*(i % 5) + 2*(r / 11) + (i >= 5);
+                pwm[r] = ledValue(n, p, levels ? levels[p] : 255, dimmer, hidden);
+                changed = !known || pwm[r] != ledValue(n, p, kept[p], _dimmer, _blinkHidden);
+            }
+        }
+        if (changed){
+            if (first < 0){
+                first = r;
+            }
+            last = r;
+        } else if (first >= 0 && (r == 132 || r - last > 2)){
+            stat |= sendBurstCmd(n, PWMSET, PWM_OFFSET + first, &pwm[first], last - first + 1);
+            first = -1;
+        }
+    }
+
+    if (kept && levels){
+        if (kept != levels){
+            memcpy(kept, levels, 120);
+        }
+        if (stat == 0){
+            _grayValid[n>>3] |= (1 << (n & 7));
+        } else {
+            _grayValid[n>>3] &= ~(1 << (n & 7));
+        }
+    }
+    #if BEAM_INSTRUMENT
+    phaseDone(_instrument.upload, t);
+    #endif
+    return stat;
+
+}
+
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::sendWriteCmd(uint8_t n, uint8_t ramsection, uint8_t subreg, uint8_t subregdata){
+
+    uint8_t stat;
+    stat = selectSection(n, ramsection);
+    if (stat == 0) {
+        stat = i2cwrite(n, subreg, subregdata);
+    }
+    return stat;
+
+}
+
+/*
+    Reads one register into value, which is 0 when the read fails. The
+    register address and the read are retried together.
+*/
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::sendReadCmd(uint8_t n, uint8_t ramsection, uint8_t subreg, uint8_t &value){
+
+    value = 0;
+    uint8_t stat = selectSection(n, ramsection);
+    if (stat != 0){
+        return stat;
+    }
+
+    for (uint8_t attempt=0; ; attempt++){
+        Wire.beginTransmission(beamAddress(n));
+        Wire.write(subreg);
+        stat = Wire.endTransmission();
+        _stats.transactions++;
+        _stats.bytes++;
+        #if BEAM_INSTRUMENT
+        instrument(1, 1);
+        _instrument.api[_api].statusPolls++;
+        #endif
+
+        if (stat == 0){
+            _stats.transactions++;
+            _stats.bytes++;
+            #if BEAM_INSTRUMENT
+            instrument(1, 1);
+            #endif
+            if (Wire.requestFrom(beamAddress(n), (uint8_t)1) == 1 && Wire.available()){
+                value = Wire.read();
+                return 0;
+            }
+            stat = BEAM_ERR_READ;
+        }
+        if (!retryAfter(n, stat, attempt)){
+            return stat;
+        }
+    }
+
+}
+
+/*
+    Writes len bytes starting at subreg of the given RAM section. The section
+    is selected once and the AS1130 auto-increments the sub register address,
+    so a whole frame goes out in one or two transactions.
+*/
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::sendBurstCmd(uint8_t n, uint8_t ramsection, uint8_t subreg, const uint8_t *data, uint8_t len){
+
+    uint8_t stat;
+    stat = selectSection(n, ramsection);
+    if (stat != 0) {
+        return stat;
+    }
+
+    while (len > 0){
+        uint8_t chunk = len;
+        if (chunk > BEAM_BURST_LENGTH){
+            chunk = BEAM_BURST_LENGTH;
+        }
+
+        stat = transmit(n, beamAddress(n), subreg, data, 0, chunk);
+        if (stat != 0){
+            return stat;
+        }
+
+        subreg += chunk;
+        data += chunk;
+        len -= chunk;
+    }
+
+    return stat;
+
+}
+
+/*
+    Writes REGSEL only when the section differs from the one last selected
+    on the n-th beam. The cache is indexed by the position in the chain, as
+    beams behind a multiplexer can share an address. Entries are dropped on
+    reset and on bus errors. Every transaction starts here, so this is also
+    where the multiplexer channel of the beam is switched to.
+*/
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::selectSection(uint8_t n, uint8_t ramsection){
+
+    // a skipped transaction fails the call too, the error that took the
+    // beam offline stays the one reported
+    if (_offline[n>>3] & (1 << (n & 7))){
+        if (_lastError == BEAM_OK){
+            _lastError = BEAM_ERR_OFFLINE;
+        }
+        _failures++;
+        return BEAM_ERR_OFFLINE;
+    }
+
+    uint8_t stat = selectChannel(n);
+    if (stat != 0){
+        return stat;
+    }
+
+    if (_regsel[n] == ramsection){
+        _stats.regselHits++;
+        return 0;
+    }
+
+    _stats.regselMisses++;
+    #if BEAM_INSTRUMENT
+    _instrument.api[_api].regselWrites++;
+    #endif
+    stat = i2cwrite(n, REGSEL, ramsection);
+    if (stat == 0){
+        _regsel[n] = ramsection;
+    }
+    return stat;
+
+}
+
+/*
+    Called once a transaction has failed on every attempt. The beam's
+    register selection is unknown from here on, and the beam is skipped
+    until the next reset, which the next print() or draw() does instead of
+    a soft replace. A beam that stopped answering therefore costs each
+    call at most one round of attempts.
+*/
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::busError(uint8_t n){
+    _regsel[n] = REGSEL_NONE;
+    _offline[n>>3] |= (1 << (n & 7));
+    _muxChannel = BEAM_NO_MUX;
+    _busFault = true;
+}
+
+/*
+    Sends subreg followed by len bytes to address on behalf of the n-th
+    beam, the bytes come from data or are len copies of value when data is
+    0. A failed attempt is repeated up to BEAM_I2C_RETRIES times, see
+    retryAfter().
+*/
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::transmit(uint8_t n, uint8_t address, uint8_t subreg, const uint8_t *data, uint8_t value, uint8_t len){
+
+    for (uint8_t attempt=0; ; attempt++){
+        Wire.beginTransmission(address);
+        Wire.write(subreg);
+        for (uint8_t i=0; i<len; i++){
+            Wire.write(data ? data[i] : value);
+        }
+        uint8_t stat = Wire.endTransmission();
+        _stats.transactions++;
+        _stats.bytes += len + 1;
+        #if BEAM_INSTRUMENT
+        instrument(1, len + 1);
+        #endif
+
+        if (stat == 0){
+            return 0;
+        }
+        if (!retryAfter(n, stat, attempt)){
+            return stat;
+        }
+    }
+
+}
+
+/*
+    Counts a failed attempt against the n-th beam and tells whether to try
+    again. A timeout or bus error can leave a slave holding SDA low, so the
+    bus is recovered first. After the last attempt the failure is what the
+    public call returns and the beam is taken offline.
+*/
+template <uint8_t Count, uint8_t Mode>
+bool BeamChain<Count, Mode>::retryAfter(uint8_t n, uint8_t stat, uint8_t attempt){
+
+    _stats.errors++;
+    #if BEAM_INSTRUMENT
+    _instrument.api[_api].errors++;
+    #endif
+    if (_beamErrors[n] < 0xFFFF){
+        _beamErrors[n]++;
+    }
+
+    bool retry = (attempt < BEAM_I2C_RETRIES && stat != BEAM_ERR_LENGTH);
+    TRACE(retry ? BEAM_EV_RETRY : BEAM_EV_OFFLINE, n, BEAM_TRACE_NONE, stat);
+
+    if (stat == BEAM_ERR_BUS || stat == BEAM_ERR_TIMEOUT){
+        recoverBus();
+    }
+
+    if (retry){
+        return true;
+    }
+
+    _lastError = stat;
+    _failures++;
+    busError(n);
+    return false;
+
+}
+
+/*
+    Frees the bus from a slave stuck in the middle of a byte: SCL is
+    clocked until the slave lets go of SDA, at most nine times, then a
+    stop condition ends its transfer. Wire is started again afterwards
+    with the clock set through setBusClock().
+*/
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::recoverBus(){
+
+    _stats.recoveries++;
+    TRACE(BEAM_EV_RECOVER, BEAM_TRACE_NONE, BEAM_TRACE_NONE, 0);
+    Wire.end();
+
+    #if defined(PIN_WIRE_SDA) && defined(PIN_WIRE_SCL)
+    pinMode(PIN_WIRE_SDA, INPUT_PULLUP);
+    pinMode(PIN_WIRE_SCL, INPUT_PULLUP);
+    for (uint8_t i=0; i<9 && digitalRead(PIN_WIRE_SDA) == LOW; i++){
+        digitalWrite(PIN_WIRE_SCL, LOW);
+        pinMode(PIN_WIRE_SCL, OUTPUT);
+        delayMicroseconds(5);
+        pinMode(PIN_WIRE_SCL, INPUT_PULLUP);
+        delayMicroseconds(5);
+    }
+    digitalWrite(PIN_WIRE_SDA, LOW);
+    pinMode(PIN_WIRE_SDA, OUTPUT);
+    delayMicroseconds(5);
+    pinMode(PIN_WIRE_SDA, INPUT_PULLUP);
+    delayMicroseconds(5);
+    #endif
+
+    Wire.begin();
+    if (_busClock){
+        Wire.setClock(_busClock);
+    }
+    #if defined(WIRE_HAS_TIMEOUT)
+    Wire.setWireTimeout(BEAM_I2C_TIMEOUT, true);
+    #endif
+
+}
+
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::invalidateSections(){
+    for (int n=0; n<Slots; n++){
+        _regsel[n] = REGSEL_NONE;
+    }
+    _muxChannel = BEAM_NO_MUX;
+}
+
+/*
+    Opens the multiplexer channel of the n-th beam, the TCA9548A control
+    register takes one bit per channel. Nothing is sent for beams on the
+    main bus or when the channel is already open.
+*/
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::selectChannel(uint8_t n){
+
+    // a fixed chain has no multiplexer
+    if (Count != 0){
+        return 0;
+    }
+
+    uint8_t channel = _beamChannel[n];
+    if (channel == BEAM_NO_MUX || channel == _muxChannel){
+        return 0;
+    }
+
+    // the control byte takes the place of a sub register
+    uint8_t stat = transmit(n, _muxAddr, 1 << channel, 0, 0, 0);
+    if (stat == 0){
+        _muxChannel = channel;
+    }
+    return stat;
+
+}
+
+/*
+    Sends the same control register to every beam
+*/
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::writeControl(uint8_t subreg, uint8_t data){
+    for (uint8_t n=0; n<beamTotal(); n++){
+        sendWriteCmd(n, CTRL, subreg, data);
+    }
+}
+
+/*
+    Turns the beam argument of the public calls into a position in the
+    chain: -1 is the first beam, values below 0x30 are positions and
+    anything else an I2C address. Returns -1 for beams not in the chain.
+*/
+template <uint8_t Count, uint8_t Mode>
+int BeamChain<Count, Mode>::findBeam(int beam){
+
+    if (beam < 0){
+        return 0;
+    }
+    if (beam < 0x30){
+        return (beam < beamTotal()) ? beam : -1;
+    }
+    for (uint8_t n=0; n<beamTotal(); n++){
+        if (beamAddress(n) == beam){
+            return n;
+        }
+    }
+    return -1;
+
+}
+
+/*
+    Fills len registers starting at subreg with the same value, in bursts
+    like sendBurstCmd.
+*/
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::sendFillCmd(uint8_t n, uint8_t ramsection, uint8_t subreg, uint8_t value, uint8_t len){
+
+    uint8_t stat;
+    stat = selectSection(n, ramsection);
+    if (stat != 0) {
+        return stat;
+    }
+
+    while (len > 0){
+        uint8_t chunk = len;
+        if (chunk > BEAM_BURST_LENGTH){
+            chunk = BEAM_BURST_LENGTH;
+        }
+
+        stat = transmit(n, beamAddress(n), subreg, 0, value, chunk);
+        if (stat != 0){
+            return stat;
+        }
+
+        subreg += chunk;
+        len -= chunk;
+    }
+
+    return stat;
+
+}
+
+/*
+    Sets up the upload state machine, the beams are only stopped when they
+    are still configured, see setSoftReplace()
+*/
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::startJob(){
+
+    // without a beam the steps would address _beamAddr[0], the general call
+    if (beamTotal() == 0){
+        _jobState = JOB_IDLE;
+        return BEAM_ERR_ARGUMENT;
+    }
+
+    _jobBeam = 0;
+    _jobItem = 0;
+    _jobPos = 0;
+    _jobCol = 0;
+    _jobSteps = 0;
+
+    uint8_t beams = beamTotal();
+    uint16_t frames = MAXFRAME;
+
+    if (_jobKind == JOB_PRINT){
+        // count the columns to estimate how many frames the text needs
+        uint16_t cols = 0;
+        uint16_t i = 0;
+        while (_jobText[i] != 0){
+            uint8_t glyph = nextGlyph(_jobText, i);
+            cols += pgm_read_word_near(&fontOffsets[glyph+1]) - pgm_read_word_near(&fontOffsets[glyph]);
+        }
+        frames = cols / 24 + 1;
+    }
+    _jobFrames = frames;
+    _jobTotal = beams * (MAXFRAME + frames) + beams + 1;
+
+    if (_jobKind == JOB_STATIC){
+        _jobFrames = 1;
+        _jobTotal = 2 * beams + 1;
+    }
+
+    if (_softReplace && _configured && !_busFault){
+        // the picture frame is updated in place, no need to stop the beams
+        if (_jobKind == JOB_STATIC){
+            startUpload();
+        } else {
+            _jobState = JOB_STOP;
+        }
+    } else {
+        _jobState = JOB_RESET;
+        _jobTotal += beams * (INIT_ITEMS + 1);
+    }
+
+    TRACE(BEAM_EV_JOB, BEAM_TRACE_NONE, _jobFrames, _jobKind);
+    return BEAM_OK;
+
+}
+
+/*
+    Performs one step of the upload, every step costs a bounded number of
+    I2C transactions. Returns false while waiting for the reset pulse.
+*/
+template <uint8_t Count, uint8_t Mode>
+bool BeamChain<Count, Mode>::jobStep(){
+
+    uint8_t beams = beamTotal();
+    _jobSteps++;
+
+    switch (_jobState){
+
+      case JOB_RESET:
+        // resets beam - will clear all beams, see note on page 24
+        // of AS1130 datasheet
+        pinMode(_rst, OUTPUT);
+        digitalWrite(_rst, LOW);
+        _jobTimer = millis();
+        _jobStart = micros();
+        _jobState = JOB_RESET_LOW;
+        return true;
+
+      case JOB_RESET_LOW:
+        _jobSteps--;
+        if (millis() - _jobTimer < 100){
+            return false;
+        }
+        digitalWrite(_rst, HIGH);
+        _jobTimer = millis();
+        _jobState = JOB_RESET_HIGH;
+        return true;
+
+      case JOB_RESET_HIGH:
+        _jobSteps--;
+        if (millis() - _jobTimer < 250){
+            return false;
+        }
+        forgetBeams();
+        _timing.resetMicros = micros() - _jobStart;
+        _timing.configMicros = 0;
+        _timing.framesMicros = 0;
+        _timing.pwmMicros = 0;
+        _jobBeam = 0;
+        _jobItem = 0;
+        _jobState = JOB_INIT;
+        return true;
+
+      case JOB_STOP:
+        // stop playback but keep the configuration
+        sendWriteCmd(_jobBeam, CTRL, SHDN, 0x02);
+        if (++_jobBeam >= beams){
+            _jobBeam = 0;
+            if (_busFault){
+                _jobState = JOB_RESET;
+                _jobTotal += beams * (INIT_ITEMS + 1);
+            } else {
+                startUpload();
+            }
+        }
+        return true;
+
+      case JOB_INIT:
+        initializeStep(_jobBeam, _jobItem);
+        if (++_jobItem >= INIT_ITEMS){
+            _jobItem = 0;
+            if (++_jobBeam >= beams){
+                _jobBeam = 0;
+                _configured = !_busFault;
+                startUpload();
+            }
+        }
+        return true;
+
+      case JOB_CLEAR:
+        // only blank what the previous message left in the played frames
+        if (staleFrame(_jobBeam, _jobItem)){
+            for (int z=0; z<12; z++){
+                cs[z] = 0x00;
+            }
+            writeFrame(_jobBeam, _jobItem);
+        }
+        if (++_jobBeam >= beams){
+            _jobBeam = 0;
+            if (++_jobItem >= MAXFRAME){
+                _jobItem = 0;
+                _jobState = JOB_RENDER;
+            }
+        }
+        return true;
+
+      case JOB_RENDER:
+        uploadStep();
+        return true;
+
+      case JOB_DEFAULTS:
+        if (_jobKind == JOB_STATIC){
+            writeStaticDefaults(_jobBeam);
+        } else {
+            writePrintDefaults(_jobBeam);
+        }
+        if (++_jobBeam > beams){
+            _jobBeam = 0;
+            _jobState = (_jobKind >= JOB_STREAM) ? JOB_STREAM_START : JOB_IDLE;
+        }
+        return true;
+
+      case JOB_STREAM_START:
+        // slaves first, the clock sync master is the last beam
+        for (uint8_t n=0; n<beams; n++){
+            sendWriteCmd(n, CTRL, SHDN, 0x03);
+        }
+        _statusTimer = millis();
+        _jobState = JOB_STREAMING;
+        return true;
+
+      case JOB_STREAMING:
+        _jobSteps--;
+        return streamStep();
+
+    }
+
+    _jobState = JOB_IDLE;
+    return true;
+
+}
+
+/*
+    Picks the first upload phase once the beams are stopped or initialized
+*/
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::startUpload(){
+
+    _jobItem = 0;
+    _jobBeam = 0;
+    _jobState = (_jobKind == JOB_STATIC || _jobKind >= JOB_STREAM) ? JOB_RENDER : JOB_CLEAR;
+
+}
+
+/*
+    Uploads the current frame of the message to the next beam, rendering
+    or converting the frame when starting on the first beam
+*/
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::uploadStep(){
+
+    uint8_t beams = beamTotal();
+
+    if (_jobKind >= JOB_STREAM){
+        // fill the whole ring before playback starts
+        streamFrame(_jobBeam);
+        if (++_jobBeam >= beams){
+            _jobBeam = 0;
+            if (++_streamNext >= MAXFRAME){
+                _lastFrameWrite = MAXFRAME - 1;
+                _jobState = JOB_DEFAULTS;
+            }
+        }
+        return;
+    }
+
+    if (_jobKind == JOB_STATIC){
+        // every beam shows its own part of the text
+        renderFrame();
+        writeFrame(_jobBeam, _frontFrame);
+        _lastFrameWrite = _frontFrame;
+        if (++_jobBeam >= beams){
+            _jobBeam = 0;
+            _jobState = JOB_DEFAULTS;
+        }
+        return;
+    }
+
+    if (_jobBeam == 0){
+        if (_jobKind == JOB_PRINT){
+            _jobLast = !renderFrame();
+        } else {
+            _jobLast = (_jobItem + 1 >= MAXFRAME);
+        }
+    }
+
+    uint8_t f = _jobItem;
+    if (_jobKind == JOB_PRINT || beams > 1){
+        f = f + frameOffset(_jobBeam);
+    }
+
+    if (f < MAXFRAME){
+        if (_jobKind == JOB_PRINT){
+            writeFrame(_jobBeam, f);
+        } else {
+            // frames.h holds the register images ready to send
+            uint8_t frameData[24];
+            memcpy_P(frameData, frameImages[_jobItem], 24);
+            #if BEAM_INSTRUMENT
+            unsigned long t = micros();
+            #endif
+            writeFrameData(_jobBeam, f, frameData);
+            #if BEAM_INSTRUMENT
+            phaseDone(_instrument.upload, t);
+            #endif
+        }
+        if (_jobBeam == 0){
+            _lastFrameWrite = f;
+        }
+    }
+
+    if (++_jobBeam >= beams){
+        _jobBeam = 0;
+        _jobItem++;
+        if (_jobLast || _jobItem >= MAXFRAME){
+            if (_jobKind == JOB_PRINT){
+                //defaults Beam to basic settings
+                loadPrintDefaults(SCROLL, 0, 6, 7, 5, 1, 0);
+            } else {
+                loadPrintDefaults(MOVIE, 1, MAXFRAME, 7, 2, 1, 0);
+            }
+            _jobState = JOB_DEFAULTS;
+        }
+    }
+
+}
+
+/*
+    Uploads frame _streamNext of the stream to the n-th beam, into ring
+    slot _streamNext % MAXFRAME. Once the source has run out the last frame
+    is repeated, or a blank one past BEAM_STREAM_BEAMS, so playback never
+    runs into frames from the previous lap.
+*/
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::streamFrame(uint8_t n){
+
+    if (_jobKind == JOB_MARQUEE){
+        // every beam renders the text with its own cursor, frameOffset()
+        // frames behind, and the first blank frame of the first beam is
+        // the last one played
+        uint8_t cols = 0;
+        if (_streamNext >= frameOffset(n)){
+            cols = packText(_jobText, _marqueePos[n], _marqueeCol[n]);
+        } else {
+            memset(cs, 0, sizeof(cs));
+        }
+        if (n == 0 && cols == 0 && _streamNext >= frameOffset(n) && _streamEnd == 0xFFFFFFFF){
+            _streamEnd = _streamNext + 1;
+        }
+        writeFrame(n, _streamNext % MAXFRAME);
+        return;
+    }
+
+    uint8_t frame[15];
+    bool fresh = false;
+
+    if (_streamNext < _streamEnd){
+        fresh = _streamSource(_streamNext, n, frame);
+        if (!fresh && n == 0){
+            _streamEnd = _streamNext;
+        }
+    }
+    #if BEAM_STREAM_BEAMS
+    if (n < StreamBeams){
+        if (fresh){
+            memcpy(_streamLast[n], frame, 15);
+        } else {
+            memcpy(frame, _streamLast[n], 15);
+        }
+        fresh = true;
+    }
+    #endif
+    if (!fresh){
+        memset(frame, 0, 15);
+    }
+
+    #if BEAM_INSTRUMENT
+    unsigned long t = micros();
+    #endif
+    packFrame(cs, RamSource(frame));
+    #if BEAM_INSTRUMENT
+    phaseDone(_instrument.convert, t);
+    #endif
+    writeFrame(n, _streamNext % MAXFRAME);
+
+}
+
+/*
+    Keeps the ring ahead of playback. The status register is only read
+    when the ring is full, at most twice per frame, and the stream ends by
+    switching every beam to a picture of its last frame. Returns false
+    while there is nothing to do.
+*/
+template <uint8_t Count, uint8_t Mode>
+bool BeamChain<Count, Mode>::streamStep(){
+
+    uint8_t beams = beamTotal();
+
+    // one frame stays between the upload and the frame on show
+    if (_jobBeam == 0 && _streamNext + 1 >= _streamShown + MAXFRAME){
+
+        if (millis() - _statusTimer < setSyncTimer() / 2){
+            return false;
+        }
+        _statusTimer = millis();
+
+        // without the first beam playback cannot be followed, the stream ends
+        uint8_t f;
+        if (sendReadCmd(0, CTRL, 0x0F, f) != 0){
+            _jobState = JOB_IDLE;
+            return true;
+        }
+        f >>= 2;
+        TRACE(BEAM_EV_STATUS, 0, f, 0);
+        uint32_t shown = _streamShown - _streamShown % MAXFRAME + f;
+        if (shown < _streamShown){
+            shown += MAXFRAME;
+        }
+        if (shown >= _streamNext){
+            TRACE(BEAM_EV_UNDERRUN, 0, f, 0);
+            _streamUnderruns++;
+        }
+        _streamShown = shown;
+
+        if (_streamShown + 1 >= _streamEnd){
+            uint8_t slot = _streamEnd ? (_streamEnd - 1) % MAXFRAME : 0;
+            for (uint8_t n=0; n<beams; n++){
+                sendWriteCmd(n, CTRL, PIC, 0 << 7 | 1 << 6 | slot);
+                sendWriteCmd(n, CTRL, MOV, 0x00);
+            }
+            _pictureMode = false;
+            _picEnabled = true;
+            _jobState = JOB_IDLE;
+            return true;
+        }
+        if (_streamNext + 1 >= _streamShown + MAXFRAME){
+            return false;
+        }
+    }
+
+    streamFrame(_jobBeam);
+    if (++_jobBeam >= beams){
+        _jobBeam = 0;
+        _streamNext++;
+    }
+    return true;
+
+}
+
+/*
+    Moves the running effect on to where it should be by now. Breathing
+    and fading change the dimmer, blinking flips the blink region, either
+    way writeGray() sends only the PWM registers that change.
+*/
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::effectStep(){
+
+    unsigned long t = millis() - _effectStart;
+    uint8_t beams = beamTotal();
+
+    if (_effect == EFFECT_BLINK){
+        bool hidden = (t / _effectPeriod) & 1;
+        if (hidden != _blinkHidden){
+            for (uint8_t n=0; n<beams; n++){
+                if (_blinkX0 < 24*(n + 1) && _blinkX1 >= 24*n){
+                    writeGray(n, grayLevels(n), _dimmer, hidden, false);
+                }
+            }
+            _blinkHidden = hidden;
+        }
+        return;
+    }
+
+    uint16_t level;
+    if (_effect == EFFECT_BREATHE){
+        // triangle wave, the gamma table turns it into an even breath
+        uint32_t phase = (t % _effectPeriod) * 510 / _effectPeriod;
+        level = (phase <= 255) ? 255 - phase : phase - 255;
+    } else if (_effectPhase == FADE_SWAP){
+        // the new message is uploaded while the beams are dark
+        if (_jobState != JOB_IDLE){
+            return;
+        }
+        _effectPhase = FADE_IN;
+        _effectStart = millis();
+        t = 0;
+        level = 0;
+    } else if (t >= _effectPeriod){
+        if (_effectPhase == FADE_OUT){
+            level = 0;
+            _effectPhase = FADE_SWAP;
+            printStaticAsync(_effectText);
+        } else {
+            level = 255;
+            _effect = EFFECT_NONE;
+        }
+    } else {
+        level = t * 255 / _effectPeriod;
+        if (_effectPhase == FADE_OUT){
+            level = 255 - level;
+        }
+    }
+
+    uint8_t dimmer = level * _effectBase / 255;
+    for (uint8_t n=0; n<beams && dimmer != _dimmer; n++){
+        writeGray(n, grayLevels(n), dimmer, _blinkHidden, false);
+    }
+    _dimmer = dimmer;
+
+}
+
+/*
+    Fills cs[] with the next 24 columns of the text being printed. Returns
+    false when the text ended inside this frame, which is then the last one.
+*/
+template <uint8_t Count, uint8_t Mode>
+bool BeamChain<Count, Mode>::renderFrame(){
+
+    // a frame that is not full means the text has ended, so does a full
+    // frame followed by an empty one which still gets written
+    return packText(_jobText, _jobPos, _jobCol) == 24;
+
+}
+
+/*
+    Packs the columns of text from the cursor textPos/textCol into cs[],
+    column n lands in bits 0-4 of cs[n/2] when n is even and in bits 5-9
+    when it is odd. A glyph that does not fit carries on from textCol in the
+    next frame. Returns the number of columns placed.
+*/
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::packText(const char *text, uint16_t &textPos, uint8_t &textCol){
+
+    #if BEAM_INSTRUMENT
+    unsigned long t = micros();
+    #endif
+
+    // work on copies, the cursor could otherwise alias cs[]
+    uint16_t pos = textPos;
+    uint8_t col = textCol;
+
+    uint8_t cscount = 0;
+    bool odd = false;
+    uint16_t word = 0;
+    uint16_t *csPtr = cs;
+
+    while (cscount < 24 && text[pos] != 0){
+
+        // pick a character to print to Beam
+        uint16_t next = pos;
+        uint8_t glyph = nextGlyph(text, next);
+        uint16_t start = pgm_read_word_near(&fontOffsets[glyph]);
+        uint8_t width = pgm_read_word_near(&fontOffsets[glyph+1]) - start;
+
+        // place the columns of the glyph that still fit in this frame
+        uint8_t n = width - col;
+        if (n > 24 - cscount){
+            n = 24 - cscount;
+        }
+        const uint8_t *fPtr = &fontColumns[start + col];
+        col += n;
+        cscount += n;
+        if (odd && n){
+            // complete the word whose even column came from the last glyph
+            *csPtr++ = word | (pgm_read_byte_near(fPtr++) << 5);
+            odd = false;
+            n--;
+        }
+        for (; n >= 2; n -= 2){
+            *csPtr++ = pgm_read_byte_near(fPtr) | (pgm_read_byte_near(fPtr + 1) << 5);
+            fPtr += 2;
+        }
+        if (n){
+            word = pgm_read_byte_near(fPtr);
+            odd = true;
+        }
+
+        if (col >= width){
+            pos = next;  // go to next character
+            col = 0;
+        }
+    }
+
+    textPos = pos;
+    textCol = col;
+
+    // flush a lone even column and blank the rest of the frame
+    if (odd){
+        *csPtr++ = word;
+    }
+    while (csPtr < cs + 12){
+        *csPtr++ = 0x00;
+    }
+
+    TRACE(BEAM_EV_RENDER, BEAM_TRACE_NONE, BEAM_TRACE_NONE, cscount);
+
+    #if BEAM_INSTRUMENT
+    phaseDone(_instrument.render, t);
+    #endif
+    return cscount;
+
+}
+
+/*
+    Pulses the reset pin and forgets everything cached about the beams.
+*/
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::resetBeams(int lowTime, int highTime){
+
+    unsigned long t = micros();
+
+    pinMode(_rst, OUTPUT);
+    digitalWrite(_rst, LOW);
+    delay(lowTime);
+    digitalWrite(_rst, HIGH);
+    delay(highTime);
+
+    forgetBeams();
+    _timing.resetMicros = micros() - t;
+
+}
+
+/*
+    Forgets everything cached about the beams after a reset pulse
+*/
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::forgetBeams(){
+
+    invalidateSections();
+    invalidateShadow();
+    memset(_pwmReady, 0, sizeof(_pwmReady));
+    memset(_grayValid, 0, sizeof(_grayValid));
+    memset(_offline, 0, sizeof(_offline));
+    _busFault = false;
+    _configured = false;
+    _pictureMode = false;
+    _picEnabled = false;
+
+}
+
+/*
+    Forgets what is known about the frames of every beam, used whenever
+    the beams are reset.
+*/
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::invalidateShadow(){
+    for (int b=0; b<ShadowBeams; b++){
+        for (int f=0; f<(MAXFRAME + 7) / 8; f++){
+            _frameDirty[b][f] = 0xFF;
+        }
+        #if BEAM_SHADOW_FRAMES
+        for (int f=0; f<(BEAM_SHADOW_FRAMES + 7) / 8; f++){
+            _shadowValid[b][f] = 0;
+        }
+        #endif
+    }
+}
+
+/*
+    Returns the slot that tracks the frames of the n-th beam, or -1 for
+    beams past BEAM_SHADOW_BEAMS whose frames are not tracked.
+*/
+template <uint8_t Count, uint8_t Mode>
+int BeamChain<Count, Mode>::beamSlot(uint8_t n){
+    return (n < ShadowBeams) ? n : -1;
+}
+
+/*
+    Tells whether frame f of the n-th beam has to be blanked before the
+    current upload: it is played back, it may still hold an earlier
+    message and the upload is not going to overwrite it anyway.
+*/
+template <uint8_t Count, uint8_t Mode>
+bool BeamChain<Count, Mode>::staleFrame(uint8_t n, uint8_t f){
+
+    if (_jobKind == JOB_STATIC || _jobKind >= JOB_STREAM){
+        return false;
+    }
+
+    // draw() starts the movie at frame 1
+    uint8_t first = (_jobKind == JOB_PRINT) ? 0 : 1;
+    uint16_t offset = 0, last = 0;
+    if (_jobKind == JOB_PRINT || beamTotal() > 1){
+        offset = frameOffset(n);
+        last = frameOffset(0);
+    }
+
+    // MOVMODE ends on the last frame the first beam writes
+    last = last + _jobFrames - 1;
+    if (last > MAXFRAME - 1){
+        last = MAXFRAME - 1;
+    }
+
+    if (f < first || f > last){
+        return false;
+    }
+    if (f >= offset && f < offset + _jobFrames){
+        return false;
+    }
+
+    int slot = beamSlot(n);
+    if (slot < 0){
+        return true;
+    }
+    return _frameDirty[slot][f>>3] & (1 << (f & 7));
+
+}
+
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::i2cwrite(uint8_t n, uint8_t cmdbyte, uint8_t databyte) {
+    return transmit(n, beamAddress(n), cmdbyte, 0, databyte, 1);
+}
+
+// convert a frame stored in RAM as a 15 (3x5) byte array
+template <uint8_t Count, uint8_t Mode>
+void BeamChain<Count, Mode>::convertFrameFromRAM(uint8_t *pFrameData){
+    #if BEAM_INSTRUMENT
+    unsigned long t = micros();
+    #endif
+    packFrame(cs, RamSource(pFrameData));
+    #if BEAM_INSTRUMENT
+    phaseDone(_instrument.convert, t);
+    #endif
+}
+
+// load a frame stored in RAM to a given BEAM at a given frame
+// number see note on see note on page 24 of AS1130 datasheet
+template <uint8_t Count, uint8_t Mode>
+uint8_t BeamChain<Count, Mode>::loadFrameFromRAM(int beam, uint8_t frameNum, uint8_t *pFrameData) {
+
+  BEAM_API(BEAM_API_LOAD_FRAME);
+  uint16_t failures = _failures;
+  int n = findBeam(beam);
+  if (n < 0) {
+    #if DEBUG
+    Serial.print("Beam not in chain: ");
+    Serial.println(beam);
+    #endif
+    return BEAM_ERR_ARGUMENT;
+  }
+
+  convertFrameFromRAM(pFrameData);
+  writeFrame(n, frameNum);
+  return result(failures);
+}
+// the names above are internal to the engine, keep them out of the sketch
+#undef BEAM_BURST_LENGTH
+#undef JOB_IDLE
+#undef JOB_RESET
+#undef JOB_RESET_LOW
+#undef JOB_RESET_HIGH
+#undef JOB_STOP
+#undef JOB_INIT
+#undef JOB_CLEAR
+#undef JOB_RENDER
+#undef JOB_DEFAULTS
+#undef JOB_STREAM_START
+#undef JOB_STREAMING
+#undef JOB_PRINT
+#undef JOB_DRAW
+#undef JOB_STATIC
+#undef JOB_STREAM
+#undef JOB_MARQUEE
+#undef EFFECT_NONE
+#undef EFFECT_BREATHE
+#undef EFFECT_CROSSFADE
+#undef EFFECT_BLINK
+#undef FADE_OUT
+#undef FADE_SWAP
+#undef FADE_IN
+#undef TRACE
+#undef BEAM_API
+#undef INIT_ITEMS
+
+#endif
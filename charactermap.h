@@ -1,7 +1,9 @@
 #ifndef __CHARMAP__
 #define __CHARMAP__
 
+#if defined(__AVR__)
 #include <avr/pgmspace.h>
+#endif
 
 /*
 ===========================================================================
@@ -17,74 +19,159 @@
 ===========================================================================
 */
 
-const uint8_t charactermap[66][7] PROGMEM = {
-{0x00,0x00,0xFF,0xFF,0xFF,0xFF},      // SPACE
-{0x17,0x0,0xFF,0xFF,0xFF,0xFF,0xFF},      // !
-{0x3,0x0,0x3,0x0,0xFF,0x0,0xFF},       // "
-{0xA,0x1F,0xA,0x1F,0xA,0x0,0xFF},     // #
-{0x17,0x15,0x1F,0x15,0x1D,0x0,0xFF},  // $
-{0x12,0x8,0x4,0x12,0x0,0xFF,0xFF},     // %
-{0xA,0x15,0xE,0x10,0x0,0xFF,0xFF},     // &
-{0x3,0x0,0xFF,0xFF,0xFF,0xFF,0xFF},       // '
-{0xE,0x11,0x0,0xFF,0xFF,0xFF,0xFF},      // (
-{0x11,0xE,0x0,0xFF,0xFF,0xFF,0xFF},      // )
-{0x5,0x2,0x5,0x0,0xFF,0xFF,0xFF},       // *
-{0x8,0x1C,0x8,0x0,0xFF,0xFF,0xFF},      // +
-{0x10,0x8,0x0,0xFF,0xFF,0xFF,0xFF},      // ,
-{0x4,0x4,0x0,0xFF,0xFF,0xFF,0xFF},       // -
-{0x10,0x0,0xFF,0xFF,0xFF,0xFF,0xFF},      // .
-{0x18,0xE,0x3,0x0,0xFF,0xFF,0xFF},      // /
-{0x1F,0x11,0x1F,0x0,0xFF,0xFF,0xFF},    // 0
-{0x2,0x1F,0x0,0xFF,0xFF,0xFF,0xFF},      // 1
-{0x1D,0x15,0x17,0x0,0xFF,0xFF,0xFF},    // 2
-{0x15,0x15,0x1F,0x0,0xFF,0xFF,0xFF},    // 3
-{0x7,0x4,0x1F,0x0,0xFF,0xFF,0xFF},      // 4
-{0x17,0x15,0x1D,0x0,0xFF,0xFF,0xFF},    // 5
-{0x1F,0x15,0x1D,0x0,0xFF,0xFF,0xFF},    // 6
-{0x1,0x1,0x1F,0x0,0xFF,0xFF,0xFF},      // 7
-{0x1F,0x15,0x1F,0x0,0xFF,0xFF,0xFF},    // 8
-{0x17,0x15,0x1F,0x0,0xFF,0xFF,0xFF},    // 9
-{0xA,0x0,0xFF,0xFF,0xFF,0xFF,0xFF},       // :
-{0xA,0x0,0xFF,0xFF,0xFF,0xFF,0xFF},       // ;
-{0x4,0xA,0x11,0x0,0xFF,0xFF,0xFF},      // <
-{0xA,0xA,0xA,0x0,0xFF,0xFF,0xFF},       // =
-{0x11,0xA,0x4,0x0,0xFF,0xFF,0xFF},      // >
-{0x1,0x15,0x7,0x0,0xFF,0xFF,0xFF},      // ?
-{0x1F,0x11,0x1D,0x15,0x1F,0x0,0xFF},  // @
-{0x1F,0x05,0x05,0x1F,0x00,0xFF,0xFF},  // A
-{0x1F,0x15,0x15,0x0A,0x00,0xFF,0xFF},  // B
-{0x0E,0x11,0x11,0x0A,0x00,0xFF,0xFF},  // C
-{0x1F,0x11,0x11,0x0E,0x00,0xFF,0xFF},  // D
-{0x1F,0x15,0x15,0x15,0x00,0xFF,0xFF},  // E
-{0x1F,0x5,0x5,0x0,0xFF,0xFF,0xFF},     // F
-{0x1F,0x11,0x15,0x1D,0x0,0xFF,0xFF},   // G
-{0x1F,0x4,0x4,0x1F,0x0,0xFF,0xFF},     // H
-{0x11,0x1F,0x11,0x0,0xFF,0xFF,0xFF},   // I
-{0x18,0x10,0x1F,0x0,0xFF,0xFF,0xFF},   // J
-{0x1F,0x4,0x1B,0x0,0xFF,0xFF,0xFF},    // K
-{0x1F,0x10,0x10,0x0,0xFF,0xFF,0xFF},   // L
-{0x1F,0x2,0x4,0x2,0x1F,0x00,0xFF},     // M
-{0x1F,0x2,0x4,0x8,0x1F,0x00,0xFF},     // N
-{0xE,0x11,0x11,0x11,0xE,0x00,0xFF},    // O
-{0x1F,0x5,0x7,0x0,0xFF,0xFF,0xFF},     // P
-{0x1F,0x11,0x15,0x19,0x1F,0x00,0xFF},  // Q
-{0x1F,0x5,0xD,0x17,0x0,0xFF,0xFF},     // R
-{0x17,0x15,0x15,0x1D,0x0,0xFF,0xFF},   // S
-{0x1,0x1F,0x1,0x0,0xFF,0xFF,0xFF},     // T
-{0x1F,0x10,0x10,0x1F,0x0,0xFF,0xFF},   // U
-{0x7,0x8,0x10,0x8,0x7,0x00,0xFF},      // V
-{0xF,0x10,0xC,0x10,0xF,0x00,0xFF},     // W
-{0x11,0xA,0x4,0xA,0x11,0x00,0xFF},     // X
-{0x1,0x2,0x1C,0x2,0x1,0x00,0xFF},      // Y
-{0x11,0x19,0x15,0x13,0x0,0xFF,0xFF},   // Z
-{0x1F,0x11,0x0,0xFF,0xFF,0xFF,0xFF},       //[
-{0x3,0xE,0x18,0x0,0xFF,0xFF,0xFF},        ///
-{0x11,0x1F,0x0,0x0,0xFF,0xFF,0xFF},       //]
-{0x6,0xE,0x1C,0xE,0x6,0x0,0xFF},        //^
-{0x10,0x10,0x10,0x0,0xFF,0xFF,0xFF},      //_
-{0x1,0x2,0x0,0xFF,0xFF,0xFF,0xFF},         //'
+/*
+    Packed font. The columns of every glyph are stored back to back in
+    fontColumns[], including the blank column that separates it from the
+    next character, bit 0 being the top row. Glyph g starts at
+    fontOffsets[g] and is fontOffsets[g+1] - fontOffsets[g] columns wide.
+
+    Glyphs 0-64 are ASCII 32 to 96 (SPACE to `), followed by a-z, { | } ~,
+    the Latin-1 characters listed in fontLatin[] and the fallback box that
+    is shown for anything else.
+*/
+#define FONT_LOWER 65
+#define FONT_BRACES 91
+#define FONT_LATIN 95
+#define FONT_LATIN_COUNT 19
+#define FONT_FALLBACK 114
+#define FONT_GLYPHS 115
 
+const uint8_t fontColumns[] PROGMEM = {
+0x0,0x0,                        // SPACE
+0x17,0x0,                       // !
+0x3,0x0,0x3,0x0,                // "
+0xA,0x1F,0xA,0x1F,0xA,0x0,      // #
+0x17,0x15,0x1F,0x15,0x1D,0x0,   // $
+0x12,0x8,0x4,0x12,0x0,          // %
+0xA,0x15,0xE,0x10,0x0,          // &
+0x3,0x0,                        // '
+0xE,0x11,0x0,                   // (
+0x11,0xE,0x0,                   // )
+0x5,0x2,0x5,0x0,                // *
+0x8,0x1C,0x8,0x0,               // +
+0x10,0x8,0x0,                   // ,
+0x4,0x4,0x0,                    // -
+0x10,0x0,                       // .
+0x18,0xE,0x3,0x0,               // /
+0x1F,0x11,0x1F,0x0,             // 0
+0x2,0x1F,0x0,                   // 1
+0x1D,0x15,0x17,0x0,             // 2
+0x15,0x15,0x1F,0x0,             // 3
+0x7,0x4,0x1F,0x0,               // 4
+0x17,0x15,0x1D,0x0,             // 5
+0x1F,0x15,0x1D,0x0,             // 6
+0x1,0x1,0x1F,0x0,               // 7
+0x1F,0x15,0x1F,0x0,             // 8
+0x17,0x15,0x1F,0x0,             // 9
+0xA,0x0,                        // :
+0xA,0x0,                        // ;
+0x4,0xA,0x11,0x0,               // <
+0xA,0xA,0xA,0x0,                // =
+0x11,0xA,0x4,0x0,               // >
+0x1,0x15,0x7,0x0,               // ?
+0x1F,0x11,0x1D,0x15,0x1F,0x0,   // @
+0x1F,0x5,0x5,0x1F,0x0,          // A
+0x1F,0x15,0x15,0xA,0x0,         // B
+0xE,0x11,0x11,0xA,0x0,          // C
+0x1F,0x11,0x11,0xE,0x0,         // D
+0x1F,0x15,0x15,0x15,0x0,        // E
+0x1F,0x5,0x5,0x0,               // F
+0x1F,0x11,0x15,0x1D,0x0,        // G
+0x1F,0x4,0x4,0x1F,0x0,          // H
+0x11,0x1F,0x11,0x0,             // I
+0x18,0x10,0x1F,0x0,             // J
+0x1F,0x4,0x1B,0x0,              // K
+0x1F,0x10,0x10,0x0,             // L
+0x1F,0x2,0x4,0x2,0x1F,0x0,      // M
+0x1F,0x2,0x4,0x8,0x1F,0x0,      // N
+0xE,0x11,0x11,0x11,0xE,0x0,     // O
+0x1F,0x5,0x7,0x0,               // P
+0x1F,0x11,0x15,0x19,0x1F,0x0,   // Q
+0x1F,0x5,0xD,0x17,0x0,          // R
+0x17,0x15,0x15,0x1D,0x0,        // S
+0x1,0x1F,0x1,0x0,               // T
+0x1F,0x10,0x10,0x1F,0x0,        // U
+0x7,0x8,0x10,0x8,0x7,0x0,       // V
+0xF,0x10,0xC,0x10,0xF,0x0,      // W
+0x11,0xA,0x4,0xA,0x11,0x0,      // X
+0x1,0x2,0x1C,0x2,0x1,0x0,       // Y
+0x11,0x19,0x15,0x13,0x0,        // Z
+0x1F,0x11,0x0,                  // [
+0x3,0xE,0x18,0x0,               // backslash
+0x11,0x1F,0x0,0x0,              // ]
+0x6,0xE,0x1C,0xE,0x6,0x0,       // ^
+0x10,0x10,0x10,0x0,             // _
+0x1,0x2,0x0,                    // `
+0xC,0x12,0x1E,0x0,              // a
+0x1F,0x12,0xC,0x0,              // b
+0xC,0x12,0x12,0x0,              // c
+0xC,0x12,0x1F,0x0,              // d
+0xC,0x16,0x14,0x0,              // e
+0x1E,0x5,0x0,                   // f
+0x12,0x15,0xF,0x0,              // g
+0x1F,0x2,0x1C,0x0,              // h
+0x1D,0x0,                       // i
+0x8,0x10,0xD,0x0,               // j
+0x1F,0x4,0x1A,0x0,              // k
+0xF,0x10,0x0,                   // l
+0x1E,0x2,0x1C,0x2,0x1C,0x0,     // m
+0x1E,0x2,0x1C,0x0,              // n
+0xC,0x12,0xC,0x0,               // o
+0x1E,0xA,0x4,0x0,               // p
+0x4,0xA,0x1E,0x0,               // q
+0x1E,0x4,0x2,0x0,               // r
+0x12,0x15,0x9,0x0,              // s
+0x2,0xF,0x12,0x0,               // t
+0xE,0x10,0x1E,0x0,              // u
+0xE,0x10,0xE,0x0,               // v
+0xE,0x10,0xC,0x10,0xE,0x0,      // w
+0x12,0xC,0x12,0x0,              // x
+0x13,0x14,0xF,0x0,              // y
+0x19,0x15,0x13,0x0,             // z
+0x4,0x1B,0x11,0x0,              // {
+0x1F,0x0,                       // |
+0x11,0x1B,0x4,0x0,              // }
+0x4,0x2,0x4,0x2,0x0,            // ~
+0x1D,0x0,                       // ¡
+0x14,0x1F,0x15,0x0,             // £
+0x7,0x5,0x7,0x0,                // °
+0x8,0x15,0x10,0x0,              // ¿
+0x1D,0xA,0x1D,0x0,              // Ä
+0xF,0x19,0x9,0x0,               // Ç
+0x1E,0x16,0x13,0x0,             // É
+0x1C,0x9,0x11,0x1C,0x0,         // Ñ
+0xD,0x12,0xD,0x0,               // Ö
+0x1D,0x10,0x1D,0x0,             // Ü
+0x1E,0x15,0xA,0x0,              // ß
+0x9,0x14,0x1C,0x0,              // à
+0x9,0x14,0x1D,0x0,              // ä
+0x4,0x1A,0xA,0x0,               // ç
+0xD,0x16,0x14,0x0,              // è
+0xC,0x16,0x15,0x0,              // é
+0x1D,0x5,0x18,0x0,              // ñ
+0x9,0x14,0x9,0x0,               // ö
+0xD,0x10,0x1D,0x0,              // ü
+0x1F,0x11,0x1F,0x0,             // fallback
+};
+
+const uint16_t fontOffsets[FONT_GLYPHS + 1] PROGMEM = {
+    0, 2, 4, 8, 14, 20, 25, 30, 32, 35,
+    38, 42, 46, 49, 52, 54, 58, 62, 65, 69,
+    73, 77, 81, 85, 89, 93, 97, 99, 101, 105,
+    109, 113, 117, 123, 128, 133, 138, 143, 148, 152,
+    157, 162, 166, 170, 174, 178, 184, 190, 196, 200,
+    206, 211, 216, 220, 225, 231, 237, 243, 249, 254,
+    257, 261, 265, 271, 275, 278, 282, 286, 290, 294,
+    298, 301, 305, 309, 311, 315, 319, 322, 328, 332,
+    336, 340, 344, 348, 352, 356, 360, 364, 370, 374,
+    378, 382, 386, 388, 392, 397, 399, 403, 407, 411,
+    415, 419, 423, 428, 432, 436, 440, 444, 448, 452,
+    456, 460, 464, 468, 472, 476
+};
 
+// Latin-1 code of each glyph from FONT_LATIN on
+const uint8_t fontLatin[FONT_LATIN_COUNT] PROGMEM = {
+    0xA1, 0xA3, 0xB0, 0xBF, 0xC4, 0xC7, 0xC9, 0xD1, 0xD6, 0xDC, 0xDF, 0xE0, 0xE4, 0xE7, 0xE8, 0xE9, 0xF1, 0xF6, 0xFC
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,190 @@
+/*
+===========================================================================
+
+  This is an example for Beam.
+
+  Beam is a beautiful LED matrix — features 120 LEDs that displays scrolling text, animations, or custom lighting effects.
+  Beam can be purchased here: http://www.hoverlabs.co
+
+  Written by Emran Mahbub and Jonathan Li for Hover Labs.
+  BSD license, all text above must be included in any redistribution
+
+
+#  ABOUT
+    Measures the I2C cost of the public Beam calls for chains of 1 to 4
+    beams and for single beam mode. Each call is reported with the number
+    of I2C transactions, bytes, the estimated bus time at 100 kHz and
+    400 kHz and the measured time, first as a table and then as CSV lines
+    (prefixed with "csv,") that can be pasted into a spreadsheet to track
+    regressions between releases.
+
+    Connect every beam of the longest chain measured. A beam that does
+    not answer is retried and then skipped until the next reset, so its
+    transactions would not be counted.
+    play() returns once every beam of a chain has been started, so its
+    measured time includes the frame time it waits for the hand-off.
+
+    The sketch also runs on Linux against simulated beams, see
+    extras/host, where "make bench" prints the same table.
+
+#  SUPPORT
+    For questions and comments, email us at support@hoverlabs.co
+===========================================================================
+*/
+#include "Arduino.h"
+#include "Wire.h"
+#include "stdint.h"
+#include "beam.h"
+
+/* pin definitions for Beam */
+#define RSTPIN 5        //use any digital pin
+#define IRQPIN 9        //optional
+
+#define CALLS 11
+
+const char shortText[] = "Hi";
+const char mediumText[] = "Hello World. This is Beam!";
+const char longText[] = "The quick brown fox jumps over the lazy dog. "
+                        "Pack my box with five dozen liquor jugs. "
+                        "How vexingly quick daft zebras jump! "
+                        "Sphinx of black quartz, judge my vow.";
+
+const char *callNames[CALLS] = {
+    "begin", "print short", "print medium", "print long", "draw",
+    "setSpeed", "setLoops", "setScroll", "play", "loadFrameFromRAM", "print repeat"
+};
+
+uint8_t ramFrame[15] = {
+    0b10101010, 0b10101010, 0b10101010,
+    0b01010101, 0b01010101, 0b01010101,
+    0b10101010, 0b10101010, 0b10101010,
+    0b01010101, 0b01010101, 0b01010101,
+    0b10101010, 0b10101010, 0b10101010
+};
+
+/* bus time scales with the clock, so 400 kHz is derived from the 100 kHz estimate */
+struct Result {
+    uint16_t transactions;
+    uint16_t bytes;
+    uint32_t at100k;
+    uint32_t micros;
+};
+
+Result results[5][CALLS];
+
+void runCall(Beam &b, int call){
+    switch (call){
+        case 0: b.begin(); break;
+        case 1: b.print(shortText); break;
+        case 2: b.print(mediumText); break;
+        case 3: b.print(longText); break;
+        case 4: b.draw(); break;
+        case 5: b.setSpeed(3); break;
+        case 6: b.setLoops(7); break;
+        case 7: b.setScroll(LEFT, FADEOFF); break;
+        case 8: b.play(); break;
+        case 9: b.loadFrameFromRAM(-1, 1, ramFrame); break;
+        case 10: b.print(shortText); break;
+    }
+}
+
+void measure(Beam &b, Result *row){
+    for (int call=0; call<CALLS; call++){
+        b.clearStats();
+        unsigned long t = micros();
+        runCall(b, call);
+        row[call].micros = micros() - t;
+
+        BeamStats s = b.getStats();
+        row[call].transactions = s.transactions;
+        row[call].bytes = s.bytes;
+        row[call].at100k = b.busMicros(100000);
+    }
+}
+
+void printLabel(int chain){
+    if (chain < 4){
+        Serial.print(chain + 1);
+        Serial.print(" beam");
+    } else {
+        Serial.print("single");
+    }
+}
+
+void printColumn(uint32_t value, int width){
+    int digits = 1;
+    for (uint32_t v = value; v >= 10; v /= 10){
+        digits++;
+    }
+    for (int i=digits; i<width; i++){
+        Serial.print(' ');
+    }
+    Serial.print(value);
+}
+
+void setup() {
+
+    Serial.begin(115200);
+    Wire.begin();
+
+    Serial.println(F("Beam I2C benchmark"));
+
+    for (int chain=0; chain<5; chain++){
+        Beam *b;
+        if (chain < 4){
+            b = new Beam(RSTPIN, IRQPIN, chain + 1);
+        } else {
+            b = new Beam(RSTPIN, IRQPIN, 0, BEAMA);
+        }
+        b->setBusClock(400000);
+        measure(*b, results[chain]);
+        delete b;
+    }
+
+    Serial.println("");
+    Serial.println(F("chain   call               trans    bytes  100kHz us  400kHz us  measured us"));
+    for (int chain=0; chain<5; chain++){
+        for (int call=0; call<CALLS; call++){
+            Result &r = results[chain][call];
+            printLabel(chain);
+            Serial.print("  ");
+            Serial.print(callNames[call]);
+            for (int i=strlen(callNames[call]); i<16; i++){
+                Serial.print(' ');
+            }
+            printColumn(r.transactions, 8);
+            printColumn(r.bytes, 9);
+            printColumn(r.at100k, 11);
+            printColumn(r.at100k / 4, 11);
+            printColumn(r.micros, 13);
+            Serial.println("");
+        }
+    }
+
+    Serial.println("");
+    Serial.println(F("csv,chain,call,transactions,bytes,us_100khz,us_400khz,us_measured"));
+    for (int chain=0; chain<5; chain++){
+        for (int call=0; call<CALLS; call++){
+            Result &r = results[chain][call];
+            Serial.print("csv,");
+            printLabel(chain);
+            Serial.print(",");
+            Serial.print(callNames[call]);
+            Serial.print(",");
+            Serial.print(r.transactions);
+            Serial.print(",");
+            Serial.print(r.bytes);
+            Serial.print(",");
+            Serial.print(r.at100k);
+            Serial.print(",");
+            Serial.print(r.at100k / 4);
+            Serial.print(",");
+            Serial.println(r.micros);
+        }
+    }
+
+}
+
+void loop() {
+
+}
@@ -14,7 +14,7 @@
     v1.0  -  Initial Release
 
 #  INSTALLATION
-    The 4 library files (beam.cpp, beam.h and charactermap.h and frames.h) are required to run Beam.
+    The 5 library files (beam.cpp, beam.h, beamchain.h, charactermap.h and frames.h) are required to run Beam.
     Run the BeamDemo.ino file.
     
 #  SUPPORT
@@ -28,7 +28,7 @@
 
 /* pin definitions for Beam */
 #define RSTPIN 5        //use any digital pin
-#define IRQPIN 9        //currently not used - leave unconnected
+#define IRQPIN 9        //optional - on an interrupt capable pin it starts chained beams without polling
 #define BEAMCOUNT 1     //number of beams daisy chained together
 
 /* Iniitialize an instance of Beam */
@@ -89,6 +89,13 @@ void loop() {
 
     } 
 
+    // BEAM_TRACE has to be set in beam.h or as a build flag, a #define in
+    // this sketch does not reach the library and fails to link, see beam.h
+    #if BEAM_TRACE
+    // hand a few trace records to Serial each time round, see drain()
+    b.drain(Serial);
+    #endif
+
     // do something else here
 
 }
@@ -0,0 +1,87 @@
+/*
+    Just enough of the Arduino core to build the Beam library and its
+    examples on a Linux host. Time is simulated, see as1130.h: millis()
+    and micros() follow the modelled bus and delay() only moves the clock.
+*/
+
+#ifndef _HOST_ARDUINO
+#define _HOST_ARDUINO
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_byte_near(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+#define pgm_read_word_near(p) (*(const uint16_t *)(p))
+#define pgm_read_ptr(p) (*(void * const *)(p))
+#define memcpy_P(d, s, n) memcpy((d), (s), (n))
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define FALLING 2
+#define NOT_AN_INTERRUPT -1
+#define DEC 10
+#define HEX 16
+
+//Interrupt pins of an Uno
+#define digitalPinToInterrupt(p) ((p) == 2 ? 0 : ((p) == 3 ? 1 : NOT_AN_INTERRUPT))
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+unsigned long millis();
+unsigned long micros();
+void attachInterrupt(uint8_t interrupt, void (*handler)(void), int mode);
+void detachInterrupt(uint8_t interrupt);
+void noInterrupts();
+void interrupts();
+
+//Print and Stream write to stdout and read nothing
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) { return putchar(c) == EOF ? 0 : 1; }
+    size_t print(const char *s) { size_t n = 0; while (*s) n += write(*s++); return n; }
+    size_t print(const __FlashStringHelper *s) { return print(reinterpret_cast<const char *>(s)); }
+    size_t print(char c) { return write(c); }
+    size_t print(unsigned char v, int base = DEC) { return print((unsigned long)v, base); }
+    size_t print(int v, int base = DEC) { return print((long)v, base); }
+    size_t print(unsigned int v, int base = DEC) { return print((unsigned long)v, base); }
+    size_t print(long v, int base = DEC) { char b[24]; snprintf(b, sizeof(b), base == HEX ? "%lX" : "%ld", v); return print(b); }
+    size_t print(unsigned long v, int base = DEC) { char b[24]; snprintf(b, sizeof(b), base == HEX ? "%lX" : "%lu", v); return print(b); }
+    size_t print(double v, int digits = 2) { char b[48]; snprintf(b, sizeof(b), "%.*f", digits, v); return print(b); }
+    size_t println() { return print("\n"); }
+    template <class T> size_t println(T v) { size_t n = print(v); return n + println(); }
+    template <class T> size_t println(T v, int format) { size_t n = print(v, format); return n + println(); }
+};
+
+class Stream : public Print {
+  public:
+    void begin(unsigned long) {}
+    virtual int available() { return 0; }
+    virtual int read() { return -1; }
+    size_t readBytes(uint8_t *buffer, size_t length) {
+        size_t n = 0;
+        for (int c; n < length && (c = read()) >= 0; n++) buffer[n] = (uint8_t)c;
+        return n;
+    }
+};
+
+extern Stream Serial;
+
+#endif
@@ -0,0 +1,33 @@
+/*
+    Wire for the host build, every transaction goes to the simulated
+    AS1130 chain in as1130.h
+*/
+
+#ifndef _HOST_WIRE
+#define _HOST_WIRE
+
+#include "Arduino.h"
+
+#define BUFFER_LENGTH 32
+#define WIRE_HAS_TIMEOUT
+
+class TwoWire {
+  public:
+    void begin();
+    void end();
+    void setClock(uint32_t clockHz);
+    void setWireTimeout(uint32_t timeoutMicros, bool resetOnTimeout);
+    void beginTransmission(uint8_t address);
+    void beginTransmission(int address) { beginTransmission((uint8_t)address); }
+    size_t write(uint8_t data);
+    size_t write(const uint8_t *data, size_t length);
+    uint8_t endTransmission(uint8_t sendStop = 1);
+    uint8_t requestFrom(uint8_t address, uint8_t quantity);
+    uint8_t requestFrom(int address, int quantity) { return requestFrom((uint8_t)address, (uint8_t)quantity); }
+    int available();
+    int read();
+};
+
+extern TwoWire Wire;
+
+#endif
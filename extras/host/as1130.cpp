@@ -0,0 +1,498 @@
+/*
+    Simulated AS1130 chain, host Wire and the parts of the Arduino core
+    the Beam library uses, see as1130.h
+*/
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "as1130.h"
+
+#define AS1130_REGSEL 0xFD
+#define AS1130_PWMSET 0x40
+#define AS1130_CTRL 0xC0
+#define AS1130_PWM_OFFSET 0x18
+
+AS1130Bus sim;
+TwoWire Wire;
+Stream Serial;
+
+uint32_t AS1130::movieSteps(uint64_t now) const {
+
+    if (!(control[0x09] & 0x01)){
+        return 0;
+    }
+    uint64_t frameTime = 1000ULL * AS1130_FRAME_MICROS * ((control[0x03] & 0x0F) ? (control[0x03] & 0x0F) : 1);
+    return (uint32_t)((now - started) / frameTime);
+
+}
+
+int AS1130::frameOnShow(uint64_t now) const {
+
+    if (!(control[0x09] & 0x01)){
+        return -1;
+    }
+    if (control[0x01] & 0x40){
+        uint8_t first = control[0x01] & 0x3F;
+        uint8_t last = control[0x02] & 0x3F;
+        uint8_t count = (last >= first) ? last - first + 1 : 1;
+        return first + movieSteps(now) % count;
+    }
+    if (control[0x00] & 0x40){
+        return control[0x00] & 0x3F;
+    }
+    return -1;
+
+}
+
+bool AS1130::led(uint8_t f, uint8_t x, uint8_t y) const {
+
+    uint16_t cs = frame[f][2 * (x / 2)] | frame[f][2 * (x / 2) + 1] << 8;
+    return (cs >> (y + 5 * (x & 1))) & 1;
+
+}
+
+uint8_t AS1130::ledPwm(uint8_t set, uint8_t x, uint8_t y) const {
+
+    return pwm[set][11 * (x / 2) + y + 5 * (x & 1)];
+
+}
+
+AS1130Bus::AS1130Bus(){
+
+    clockHz = 100000;
+    resetPin = 5;
+    irqWired = true;
+    timeoutMicros = 25000;
+    muxAddress = 0x70;
+    failAddress = 0xFF;
+    failStatus = 2;
+    defaults();
+
+}
+
+void AS1130Bus::defaults(){
+
+    for (uint8_t a=0; a<8; a++){
+        detach(0x30 | a);
+        for (uint8_t ch=0; ch<8; ch++){
+            detach(0x30 | a, ch);
+        }
+    }
+    mux = false;
+    muxMask = 0;
+
+    static const uint8_t beams[4] = {0x36, 0x34, 0x30, 0x37};
+    for (uint8_t n=0; n<4; n++){
+        attach(beams[n]);
+    }
+
+}
+
+/*
+    Puts a chip at address on the main bus, or on a channel of the
+    multiplexer, which then answers at muxAddress
+*/
+AS1130 *AS1130Bus::attach(uint8_t address, int channel){
+
+    if ((address & 0xF8) != 0x30 || channel > 7){
+        return 0;
+    }
+    AS1130 *c = (channel < 0) ? &chips[address & 7] : &muxed[channel][address & 7];
+    memset(c, 0, sizeof(*c));
+    c->address = address;
+    c->present = true;
+    if (channel >= 0){
+        mux = true;
+    }
+    return c;
+
+}
+
+void AS1130Bus::detach(uint8_t address, int channel){
+
+    AS1130 *c = chip(address, channel);
+    if (c){
+        c->present = false;
+    }
+
+}
+
+AS1130 *AS1130Bus::chip(uint8_t address, int channel){
+
+    if ((address & 0xF8) != 0x30 || channel > 7){
+        return 0;
+    }
+    AS1130 *c = (channel < 0) ? &chips[address & 7] : &muxed[channel][address & 7];
+    return c->present ? c : 0;
+
+}
+
+/*
+    The chip answering at address, a chip on the main bus comes before
+    the chips on the enabled multiplexer channels
+*/
+AS1130 *AS1130Bus::route(uint8_t address){
+
+    AS1130 *c = chip(address);
+    for (uint8_t ch=0; !c && ch<8; ch++){
+        if (muxMask >> ch & 1){
+            c = chip(address, ch);
+        }
+    }
+    return c;
+
+}
+
+/*
+    Reset pulse, every chip comes back shut down with cleared memory
+*/
+void AS1130Bus::reset(){
+
+    AS1130 *all[72];
+    for (uint8_t a=0; a<8; a++){
+        all[a] = &chips[a];
+        for (uint8_t ch=0; ch<8; ch++){
+            all[8 + 8 * ch + a] = &muxed[ch][a];
+        }
+    }
+    for (uint8_t i=0; i<72; i++){
+        if (all[i]->present){
+            uint8_t address = all[i]->address;
+            memset(all[i], 0, sizeof(*all[i]));
+            all[i]->address = address;
+            all[i]->present = true;
+        }
+    }
+    resets++;
+
+}
+
+void AS1130Bus::clearCounters(){
+
+    transactions = 0;
+    bytes = 0;
+    busNanos = 0;
+    regselWrites = 0;
+    statusReads = 0;
+    irqs = 0;
+    muxWrites = 0;
+    nacks = 0;
+    overflows = 0;
+    strayWrites = 0;
+    resets = 0;
+    busRestarts = 0;
+
+}
+
+/*
+    Moves the clock on, in steps of at most a millisecond so that movie
+    interrupts are raised on time
+*/
+void AS1130Bus::advance(uint64_t micros){
+
+    while (micros){
+        uint64_t step = (micros > 1000) ? 1000 : micros;
+        now += 1000 * step;
+        micros -= step;
+        tick();
+    }
+
+}
+
+/*
+    Bus time of a transaction of length data bytes: start, address byte,
+    data bytes with their acknowledge bits, stop
+*/
+void AS1130Bus::charge(uint8_t length){
+
+    uint64_t ns = (2ULL + 9ULL * (length + 1)) * 1000000000ULL / clockHz;
+    now += ns;
+    busNanos += ns;
+    tick();
+
+}
+
+/*
+    Raises the movie interrupt of chips that reached their interrupt frame,
+    the IRQ outputs of a chain share one line
+*/
+void AS1130Bus::tick(){
+
+    for (uint8_t i=0; i<(mux ? 72 : 8); i++){
+        AS1130 *c = (i < 8) ? &chips[i] : &muxed[(i - 8) / 8][(i - 8) % 8];
+        if (!c->present || c->irqPending || !(c->control[0x07] & 0x01) || !(c->control[0x01] & 0x40) || !(c->control[0x09] & 0x01)){
+            continue;
+        }
+        if ((c->control[0x01] & 0x3F) + c->movieSteps(now) >= c->control[0x08]){
+            c->irqPending = true;
+            irqs++;
+            if (isr && irqWired){
+                isr();
+            }
+        }
+    }
+
+}
+
+static void store(AS1130Bus &bus, AS1130 *c, uint8_t value){
+
+    uint8_t section = c->section;
+    uint8_t sub = c->pointer++;
+
+    if (section >= 0x01 && section <= AS1130_FRAMES && sub < 24){
+        c->frame[section - 1][sub] = value;
+    } else if (section >= AS1130_PWMSET && section < AS1130_PWMSET + AS1130_SETS && sub < AS1130_PWM_OFFSET){
+        c->blink[section - AS1130_PWMSET][sub] = value;
+    } else if (section >= AS1130_PWMSET && section < AS1130_PWMSET + AS1130_SETS && sub < AS1130_PWM_OFFSET + AS1130_PWM){
+        c->pwm[section - AS1130_PWMSET][sub - AS1130_PWM_OFFSET] = value;
+    } else if (section == AS1130_CTRL && sub < 16){
+        if (sub == 0x09 && (value & 0x01) && !(c->control[0x09] & 0x01)){
+            c->started = bus.now;
+        }
+        c->control[sub] = value;
+    } else {
+        bus.strayWrites++;
+    }
+
+}
+
+static uint8_t load(AS1130Bus &bus, AS1130 *c){
+
+    uint8_t section = c->section;
+    uint8_t sub = c->pointer++;
+
+    if (section >= 0x01 && section <= AS1130_FRAMES && sub < 24){
+        return c->frame[section - 1][sub];
+    }
+    if (section >= AS1130_PWMSET && section < AS1130_PWMSET + AS1130_SETS && sub < AS1130_PWM_OFFSET){
+        return c->blink[section - AS1130_PWMSET][sub];
+    }
+    if (section >= AS1130_PWMSET && section < AS1130_PWMSET + AS1130_SETS && sub < AS1130_PWM_OFFSET + AS1130_PWM){
+        return c->pwm[section - AS1130_PWMSET][sub - AS1130_PWM_OFFSET];
+    }
+    if (section == AS1130_CTRL && sub == 0x0E){
+        uint8_t pending = c->irqPending;
+        c->irqPending = false;
+        return pending;
+    }
+    if (section == AS1130_CTRL && sub == 0x0F){
+        int f = c->frameOnShow(bus.now);
+        bus.statusReads++;
+        return (f < 0) ? 0 : f << 2;
+    }
+    if (section == AS1130_CTRL && sub < 16){
+        return c->control[sub];
+    }
+    return 0;
+
+}
+
+/*
+    Ends the transaction in txData, returns the Wire.endTransmission() status
+*/
+uint8_t AS1130Bus::write(){
+
+    uint8_t length = (txLength > BUFFER_LENGTH) ? BUFFER_LENGTH : txLength;
+    transactions++;
+    bytes += length;
+    charge(length);
+
+    if (failCount && (failAddress == 0xFF || failAddress == txAddress)){
+        failCount--;
+        if (failStatus == 5){
+            advance(timeoutMicros);
+        }
+        return failStatus;
+    }
+
+    if (mux && txAddress == muxAddress){
+        if (length == 1){
+            muxMask = txData[0];
+            muxWrites++;
+        }
+        return 0;
+    }
+
+    AS1130 *c = route(txAddress);
+    if (!c){
+        nacks++;
+        return 2;
+    }
+    if (length == 0){
+        return 0;
+    }
+
+    if (txData[0] == AS1130_REGSEL){
+        if (length > 1){
+            c->section = txData[length - 1];
+            regselWrites++;
+        }
+        return 0;
+    }
+    c->pointer = txData[0];
+    for (uint8_t i=1; i<length; i++){
+        store(*this, c, txData[i]);
+    }
+    return 0;
+
+}
+
+uint8_t AS1130Bus::read(uint8_t address, uint8_t quantity){
+
+    if (quantity > BUFFER_LENGTH){
+        quantity = BUFFER_LENGTH;
+    }
+    transactions++;
+    bytes += quantity;
+    charge(quantity);
+    rxLength = 0;
+    rxPos = 0;
+
+    AS1130 *c = route(address);
+    if (!c){
+        nacks++;
+        return 0;
+    }
+    if (readFailures){
+        readFailures--;
+        return 0;
+    }
+    while (rxLength < quantity){
+        rxData[rxLength++] = load(*this, c);
+    }
+    return quantity;
+
+}
+
+void AS1130Bus::dumpFrame(FILE *out, uint8_t address, int f, int channel){
+
+    AS1130 *c = chip(address, channel);
+    if (!c){
+        fprintf(out, "no beam at 0x%02X\n", address);
+        return;
+    }
+    if (f < 0){
+        f = c->frameOnShow(now);
+    }
+    fprintf(out, "0x%02X frame %d\n", address, f);
+    for (uint8_t y=0; y<5; y++){
+        for (uint8_t x=0; x<24; x++){
+            fputc((f >= 0 && f < AS1130_FRAMES && c->led(f, x, y)) ? '#' : '.', out);
+        }
+        fputc('\n', out);
+    }
+
+}
+
+void AS1130Bus::dumpChain(FILE *out, const uint8_t *addresses, uint8_t count){
+
+    for (uint8_t y=0; y<5; y++){
+        for (uint8_t n=0; n<count; n++){
+            AS1130 *c = chip(addresses[n]);
+            int f = c ? c->frameOnShow(now) : -1;
+            for (uint8_t x=0; x<24; x++){
+                fputc((f >= 0 && c->led(f, x, y)) ? '#' : '.', out);
+            }
+            fputc((n + 1 < count) ? ' ' : '\n', out);
+        }
+    }
+
+}
+
+void TwoWire::begin(){
+}
+
+void TwoWire::end(){
+    sim.busRestarts++;
+}
+
+void TwoWire::setClock(uint32_t clockHz){
+    sim.clockHz = clockHz;
+}
+
+void TwoWire::setWireTimeout(uint32_t timeoutMicros, bool){
+    sim.timeoutMicros = timeoutMicros;
+}
+
+void TwoWire::beginTransmission(uint8_t address){
+    sim.txAddress = address;
+    sim.txLength = 0;
+}
+
+size_t TwoWire::write(uint8_t data){
+    if (sim.txLength >= BUFFER_LENGTH){
+        sim.overflows++;
+        return 0;
+    }
+    sim.txData[sim.txLength++] = data;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t length){
+    size_t n = 0;
+    while (length--){
+        n += write(*data++);
+    }
+    return n;
+}
+
+uint8_t TwoWire::endTransmission(uint8_t){
+    return sim.write();
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity){
+    return sim.read(address, quantity);
+}
+
+int TwoWire::available(){
+    return sim.rxLength - sim.rxPos;
+}
+
+int TwoWire::read(){
+    return (sim.rxPos < sim.rxLength) ? sim.rxData[sim.rxPos++] : -1;
+}
+
+void pinMode(uint8_t, uint8_t){
+}
+
+void digitalWrite(uint8_t pin, uint8_t value){
+    if (pin == sim.resetPin && value == LOW){
+        sim.reset();
+    }
+}
+
+int digitalRead(uint8_t){
+    return HIGH;
+}
+
+void delay(unsigned long ms){
+    sim.advance(1000ULL * ms);
+}
+
+void delayMicroseconds(unsigned int us){
+    sim.advance(us);
+}
+
+unsigned long millis(){
+    sim.advance(1);
+    return sim.now / 1000000;
+}
+
+unsigned long micros(){
+    sim.advance(1);
+    return sim.now / 1000;
+}
+
+void attachInterrupt(uint8_t, void (*handler)(void), int){
+    sim.isr = handler;
+}
+
+void detachInterrupt(uint8_t){
+    sim.isr = 0;
+}
+
+void noInterrupts(){
+}
+
+void interrupts(){
+}
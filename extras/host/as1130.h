@@ -0,0 +1,113 @@
+/*
+    Simulated AS1130 chain behind the host Wire, for running the Beam
+    library, its examples and benchmarks on Linux without hardware.
+
+    Every write is decoded the way the chip does it: a write to REGSEL
+    selects a RAM section, other writes store their bytes from the sub
+    register on with auto increment, into frame, blink, PWM or control
+    memory. Reads return that memory, except the frame status register
+    0x0F which reports the frame on show and the interrupt status 0x0E
+    which clears on read.
+
+    Time is simulated. Each transaction moves the clock by its modelled
+    bus time at clockHz (start, 9 bits per byte including the address,
+    stop), delay() moves it by the delay and every millis() or micros()
+    call by one microsecond, so that polling loops run down. Movies play
+    from the first frame in MOV to the last frame in MOVMODE, one frame
+    per frame time, and repeat. Scrolling and fading are not modelled, a
+    scrolling movie moves on one whole frame per frame time.
+*/
+
+#ifndef _HOST_AS1130
+#define _HOST_AS1130
+
+#include "Arduino.h"
+#include "Wire.h"
+
+#define AS1130_FRAMES 36
+#define AS1130_SETS 6
+#define AS1130_PWM 132
+#define AS1130_FRAME_MICROS 32500
+
+struct AS1130 {
+    uint8_t address;
+    bool present;
+    uint8_t section;                            //last REGSEL write
+    uint8_t pointer;                            //next sub register, auto increments
+    uint8_t frame[AS1130_FRAMES][24];           //sections 0x01 to 0x24
+    uint8_t blink[AS1130_SETS][24];             //sections 0x40 to 0x45, sub registers 0x00 to 0x17
+    uint8_t pwm[AS1130_SETS][AS1130_PWM];       //same sections, sub registers 0x18 to 0x9B
+    uint8_t control[16];                        //section 0xC0
+    bool irqPending;
+    uint64_t started;                           //when SHDN last left shutdown, in ns
+
+    //frames of the movie played since it started, 0 when shut down
+    uint32_t movieSteps(uint64_t now) const;
+    //frame the chip shows, -1 when shut down or showing nothing
+    int frameOnShow(uint64_t now) const;
+    bool led(uint8_t f, uint8_t x, uint8_t y) const;
+    uint8_t ledPwm(uint8_t set, uint8_t x, uint8_t y) const;
+};
+
+struct AS1130Bus {
+    AS1130 chips[8];                            //0x30 to 0x37 on the main bus
+    AS1130 muxed[8][8];                         //the same addresses behind each TCA9548A channel
+    bool mux;
+    uint8_t muxAddress, muxMask;
+
+    uint32_t clockHz;
+    uint64_t now;                               //simulated time in ns
+    int resetPin;                               //LOW resets every chip
+    bool irqWired;                              //the IRQ line reaches the attached interrupt
+    uint32_t timeoutMicros;                     //Wire.setWireTimeout()
+    void (*isr)(void);
+
+    //counters, see clearCounters()
+    uint32_t transactions;
+    uint32_t bytes;                             //data bytes, without the address byte
+    uint64_t busNanos;                          //modelled bus time of the transactions
+    uint32_t regselWrites;
+    uint32_t statusReads;
+    uint32_t irqs;
+    uint32_t muxWrites;
+    uint32_t nacks;
+    uint32_t overflows;                         //bytes written past BUFFER_LENGTH
+    uint32_t strayWrites;                       //writes outside the modelled memory
+    uint32_t resets;
+    uint32_t busRestarts;                       //Wire.end() calls
+
+    //fault injection: the next failCount writes to failAddress (0xFF for any)
+    //end with failStatus, the next readFailures reads return nothing
+    uint16_t failCount;
+    uint8_t failAddress, failStatus;
+    uint16_t readFailures;
+
+    AS1130Bus();
+    //the four Beam addresses present on the main bus, nothing else
+    void defaults();
+    AS1130 *attach(uint8_t address, int channel = -1);
+    void detach(uint8_t address, int channel = -1);
+    AS1130 *chip(uint8_t address, int channel = -1);
+    void reset();
+    void clearCounters();
+    void advance(uint64_t micros);
+    uint64_t micros() const { return now / 1000; }
+    double busMillis() const { return busNanos / 1e6; }
+    //frame f of the chip as ASCII art, -1 dumps the frame on show
+    void dumpFrame(FILE *out, uint8_t address, int f = -1, int channel = -1);
+    //what the first count addresses show, side by side
+    void dumpChain(FILE *out, const uint8_t *addresses, uint8_t count);
+
+    //used by the host Wire and core
+    uint8_t txAddress, txLength, rxLength, rxPos;
+    uint8_t txData[BUFFER_LENGTH], rxData[BUFFER_LENGTH];
+    AS1130 *route(uint8_t address);
+    void charge(uint8_t length);
+    void tick();
+    uint8_t write();
+    uint8_t read(uint8_t address, uint8_t quantity);
+};
+
+extern AS1130Bus sim;
+
+#endif
@@ -0,0 +1,54 @@
+/*
+    Prints text on a simulated chain and shows what ended up in the frame
+    memory of each beam as ASCII art, with the I2C traffic it took.
+
+        beamdump [-b beams] [-c clockHz] text
+*/
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "beam.h"
+#include "as1130.h"
+
+#include <unistd.h>
+
+int main(int argc, char **argv){
+
+    int beams = 1;
+    uint32_t clockHz = 100000;
+    for (int opt; (opt = getopt(argc, argv, "b:c:")) != -1;){
+        if (opt == 'b'){
+            beams = atoi(optarg);
+        } else if (opt == 'c'){
+            clockHz = strtoul(optarg, 0, 0);
+        } else {
+            fprintf(stderr, "usage: %s [-b beams] [-c clockHz] text\n", argv[0]);
+            return 2;
+        }
+    }
+    if (optind >= argc || beams < 1 || beams > 4){
+        fprintf(stderr, "usage: %s [-b beams] [-c clockHz] text\n", argv[0]);
+        return 2;
+    }
+
+    static const uint8_t addresses[4] = {BEAMA, BEAMB, BEAMC, BEAMD};
+    Beam b = Beam(5, 9, beams);
+    b.begin();
+    b.setBusClock(clockHz);
+    sim.clearCounters();
+    uint8_t status = b.print(argv[optind]);
+
+    printf("print: status %u, %lu transactions, %lu bytes, %lu REGSEL writes, %.2f ms on the bus at %lu Hz\n",
+        status, (unsigned long)sim.transactions, (unsigned long)sim.bytes, (unsigned long)sim.regselWrites,
+        sim.busMillis(), (unsigned long)sim.clockHz);
+
+    for (int n=0; n<beams; n++){
+        AS1130 *c = sim.chip(addresses[n]);
+        uint8_t last = c->control[MOVMODE] & 0x3F;
+        for (uint8_t f=0; f<=last; f++){
+            sim.dumpFrame(stdout, addresses[n], f);
+        }
+    }
+    return status;
+
+}
@@ -0,0 +1,88 @@
+/*
+    Cost of the calls that loop over the chain, per chain length, for Beam
+    and for the chain fixed at compile time: host time per call with the
+    simulated bus included, and the transactions and bytes each call
+    sends. Host time is no AVR cycle count, compare it between chain
+    lengths and between builds of the library.
+*/
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "beam.h"
+#include "as1130.h"
+
+#include <chrono>
+
+#define ROUNDS 2000
+
+static const struct {
+    const char *name;
+    uint8_t call;
+} calls[] = {
+    {"setSpeed()", 0},
+    {"setMode()", 1},
+    {"print()", 2},
+    {"draw()", 3},
+};
+
+template <class Chain>
+static void call(Chain &b, uint8_t c){
+    switch (c){
+      case 0: b.setSpeed(3); break;
+      case 1: b.setMode(MOVIE); break;
+      case 2: b.print("CHAIN"); break;
+      case 3: b.draw(); break;
+    }
+}
+
+//best of five runs in ns per call, the counters of the last
+template <class Chain>
+static double nanosPerCall(Chain &b, uint8_t c){
+    b.begin();
+    b.initBeam();
+    call(b, c);
+    double best = 0;
+    for (int k=0; k<5; k++){
+        sim.clearCounters();
+        std::chrono::steady_clock::time_point t = std::chrono::steady_clock::now();
+        for (int r=0; r<ROUNDS; r++){
+            call(b, c);
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t).count() / ROUNDS;
+        if (k == 0 || ns < best){
+            best = ns;
+        }
+    }
+    return best;
+}
+
+template <class Chain>
+static void row(const char *name, uint8_t c, int beams){
+    double runtime;
+    {
+        Beam b = Beam(5, 9, beams);
+        runtime = nanosPerCall(b, c);
+    }
+    uint32_t transactions = sim.transactions;
+    uint32_t bytes = sim.bytes;
+    Chain b = Chain(5, 9);
+    double fixed = nanosPerCall(b, c);
+    if (sim.transactions != transactions || sim.bytes != bytes){
+        printf("%s on BeamChain<%d> sends other traffic than on Beam\n", name, beams);
+    }
+    printf("%-10s  %5d  %7.0f  %10.0f  %12.1f  %5.0f\n", name, beams, runtime, fixed,
+        (double)sim.transactions / ROUNDS, (double)sim.bytes / ROUNDS);
+}
+
+int main(){
+
+    printf("call        beams  Beam ns  BeamChain ns  transactions  bytes\n");
+    for (size_t c=0; c<sizeof(calls)/sizeof(calls[0]); c++){
+        row<BeamChain<1> >(calls[c].name, calls[c].call, 1);
+        row<BeamChain<2> >(calls[c].name, calls[c].call, 2);
+        row<BeamChain<3> >(calls[c].name, calls[c].call, 3);
+        row<BeamChain<4> >(calls[c].name, calls[c].call, 4);
+    }
+    return 0;
+
+}
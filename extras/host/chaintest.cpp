@@ -0,0 +1,136 @@
+/*
+    Checks that chains fixed at compile time drive the beams exactly like
+    Beam does at run time: BeamChain<1> to BeamChain<4> and
+    BeamChain<1, BEAM_SINGLE> go through the same calls as the matching
+    Beam, and after every call the registers of the chips and the
+    transactions and bytes sent have to be the same.
+*/
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "beam.h"
+#include "as1130.h"
+
+#include <vector>
+
+static const uint8_t addresses[4] = {BEAMA, BEAMB, BEAMC, BEAMD};
+static int failed = 0;
+
+typedef std::vector<std::vector<uint8_t> > Snapshots;
+
+static const char *steps[] = {
+    "begin()", "print()", "setSpeed()", "play()", "setScroll()", "print() RIGHT", "play() RIGHT",
+    "draw()", "setBrightness()", "setDimmer()", "printStatic()", "flip()", "setMode()",
+    "status()", "marquee()", "loadFrameFromRAM()",
+};
+
+//the registers of every chip and the traffic since the last snapshot
+static void snapshot(Snapshots &out){
+    std::vector<uint8_t> s;
+    for (int n=0; n<4; n++){
+        AS1130 *c = sim.chip(addresses[n]);
+        s.insert(s.end(), &c->frame[0][0], &c->frame[0][0] + sizeof(c->frame));
+        s.insert(s.end(), &c->blink[0][0], &c->blink[0][0] + sizeof(c->blink));
+        s.insert(s.end(), &c->pwm[0][0], &c->pwm[0][0] + sizeof(c->pwm));
+        s.insert(s.end(), c->control, c->control + sizeof(c->control));
+    }
+    uint32_t counts[2] = {sim.transactions, sim.bytes};
+    s.insert(s.end(), (uint8_t *)counts, (uint8_t *)counts + sizeof(counts));
+    out.push_back(s);
+    sim.clearCounters();
+}
+
+template <class Chain>
+static void exercise(Chain &b, Snapshots &out){
+
+    sim.clearCounters();
+    b.begin();
+    b.initBeam();
+    snapshot(out);
+    b.print("FIXED CHAIN");
+    snapshot(out);
+    b.setSpeed(5);
+    snapshot(out);
+    b.play();
+    snapshot(out);
+    b.setScroll(RIGHT, FADEON);
+    snapshot(out);
+    b.print("TO THE RIGHT");
+    snapshot(out);
+    b.play();
+    snapshot(out);
+    b.draw();
+    snapshot(out);
+    b.setBrightness(30, 2, 100);
+    snapshot(out);
+    b.setDimmer(128);
+    snapshot(out);
+    b.printStatic("AB");
+    snapshot(out);
+    b.flip();
+    snapshot(out);
+    b.setMode(MOVIE);
+    snapshot(out);
+    b.status();
+    snapshot(out);
+    b.marquee("A MESSAGE LONGER THAN THE FRAMES OF PRINT, SCROLLING THROUGH THE RING OF FRAMES", 1);
+    while (b.streaming()){
+        b.poll();
+        sim.advance(1000);
+    }
+    snapshot(out);
+    uint8_t bitmap[15];
+    for (uint8_t k=0; k<15; k++){
+        bitmap[k] = 0x5A ^ k;
+    }
+    b.loadFrameFromRAM(BEAMA, 3, bitmap);
+    snapshot(out);
+
+}
+
+static void compare(const char *name, const Snapshots &runtime, const Snapshots &fixed){
+    for (size_t i=0; i<runtime.size() && i<fixed.size(); i++){
+        if (runtime[i] != fixed[i]){
+            printf("%s: differs from Beam after %s\n", name, steps[i]);
+            failed++;
+            return;
+        }
+    }
+    if (runtime.size() != fixed.size()){
+        printf("%s: %d snapshots, Beam %d\n", name, (int)fixed.size(), (int)runtime.size());
+        failed++;
+    }
+}
+
+//the runtime Beam is gone before the fixed chain starts, so both get the IRQ
+template <class Chain>
+static void sameAsBeam(const char *name, Chain (*fixedChain)(), Beam (*runtimeChain)()){
+    Snapshots a, b;
+    {
+        Beam runtime = runtimeChain();
+        exercise(runtime, a);
+    }
+    {
+        Chain fixed = fixedChain();
+        exercise(fixed, b);
+    }
+    compare(name, a, b);
+    if (sizeof(Chain) > sizeof(Beam)){
+        printf("%s: %d bytes, Beam %d\n", name, (int)sizeof(Chain), (int)sizeof(Beam));
+        failed++;
+    }
+}
+
+int main(){
+
+    sameAsBeam<BeamChain<1> >("BeamChain<1>", []{ return BeamChain<1>(5, 9); }, []{ return Beam(5, 9, 1); });
+    sameAsBeam<BeamChain<2> >("BeamChain<2>", []{ return BeamChain<2>(5, 9); }, []{ return Beam(5, 9, 2); });
+    sameAsBeam<BeamChain<3> >("BeamChain<3>", []{ return BeamChain<3>(5, 9); }, []{ return Beam(5, 9, 3); });
+    sameAsBeam<BeamChain<4> >("BeamChain<4>", []{ return BeamChain<4>(5, 9); }, []{ return Beam(5, 9, 4); });
+    sameAsBeam<BeamChain<1, BEAM_SINGLE> >("BeamChain<1, BEAM_SINGLE>",
+        []{ return BeamChain<1, BEAM_SINGLE>(5, 9, 0, BEAMB); }, []{ return Beam(5, 9, 0, BEAMB); });
+
+    printf("%s\n", failed ? "FAILED" : "ok");
+    return failed ? 1 : 0;
+
+}
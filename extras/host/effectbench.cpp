@@ -0,0 +1,66 @@
+/*
+    Effect step rate per chain length at 100 kHz and 400 kHz: breathe()
+    asked for more steps per second than the bus can carry, so that every
+    poll() runs a step. Also reports what a blink toggle and a crossfade
+    cost.
+*/
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "beam.h"
+#include "as1130.h"
+
+int main(){
+
+    printf("beams  clock  breathe steps/s  bytes/step  blink bytes/toggle  crossfade s\n");
+    for (uint32_t clockHz = 100000; clockHz <= 400000; clockHz *= 4){
+        for (int beams=1; beams<=4; beams++){
+            Beam b = Beam(5, 9, beams);
+            b.begin();
+            b.setBusClock(clockHz);
+            b.printStatic("EFFECTS");
+
+            b.setEffectRate(255);
+            b.breathe(2000);
+            sim.clearCounters();
+            uint64_t start = sim.now;
+            uint32_t steps = 0;
+            while (sim.now - start < 4000000000ULL){
+                uint32_t transactions = sim.transactions;
+                b.poll();
+                if (sim.transactions != transactions){
+                    steps++;
+                }
+                sim.advance(100);
+            }
+            double rate = steps / ((sim.now - start) / 1e9);
+            double perStep = (double)sim.bytes / (steps ? steps : 1);
+            b.stopEffect();
+
+            // a region across the first two beams, hidden at 500 ms and shown at 1000 ms
+            b.setEffectRate(30);
+            b.blink(22, 1, 24, 3, 500);
+            sim.clearCounters();
+            start = sim.now;
+            while (sim.now - start < 1200000000ULL){
+                b.poll();
+                sim.advance(1000);
+            }
+            double perToggle = sim.bytes / 2.0;
+            b.stopEffect();
+
+            b.crossfade("NEW", 1000);
+            start = sim.now;
+            while (b.effectRunning()){
+                b.poll();
+                sim.advance(1000);
+            }
+            double fade = (sim.now - start) / 1e9;
+
+            printf("%5d  %3lu k  %15.0f  %10.0f  %18.0f  %11.2f\n", beams, (unsigned long)clockHz / 1000,
+                rate, perStep, perToggle, fade);
+        }
+    }
+    return 0;
+
+}
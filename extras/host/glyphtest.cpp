@@ -0,0 +1,117 @@
+/*
+    Checks how text is decoded into glyphs of the packed font: ASCII,
+    { | } ~, setLowercase(), UTF-8 sequences of Latin-1 characters, and
+    the fallback glyph for control characters, truncated or invalid
+    sequences and characters the font does not have.
+*/
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "as1130.h"
+
+// nextGlyph() is private, the test calls it directly
+#define private public
+#include "beam.h"
+#undef private
+
+#include "charactermap.h"
+
+static int failed = 0;
+
+//glyph of the first character of text and how many bytes it took
+static void glyphIs(Beam &b, const char *text, uint8_t glyph, uint16_t length){
+    uint16_t pos = 0;
+    uint8_t g = b.nextGlyph(text, pos);
+    if (g != glyph || pos != length){
+        printf("\"");
+        for (const char *p = text; *p; p++){
+            printf("\\x%02X", (uint8_t)*p);
+        }
+        printf("\" lowercase %d: glyph %d after %d bytes, expected %d after %d\n", b._lowercase, g, pos, glyph, length);
+        failed++;
+    }
+}
+
+//the columns of glyph g start frame 1 of the first beam after print()
+static void printsGlyph(Beam &b, const char *text, uint8_t glyph){
+    b.print(text);
+    AS1130 *c = sim.chip(BEAMA);
+    uint16_t first = pgm_read_word_near(&fontOffsets[glyph]);
+    uint16_t last = pgm_read_word_near(&fontOffsets[glyph + 1]);
+    for (uint16_t i=first; i<last; i++){
+        uint8_t column = pgm_read_byte_near(&fontColumns[i]);
+        for (uint8_t y=0; y<5; y++){
+            if (c->led(1, i - first, y) != ((column >> y) & 1)){
+                printf("print() of glyph %d: column %d row %d wrong\n", glyph, i - first, y);
+                sim.dumpFrame(stdout, BEAMA, 1);
+                failed++;
+                return;
+            }
+        }
+    }
+}
+
+int main(){
+
+    Beam b = Beam(5, 9, 1);
+    b.begin();
+
+    for (int lower=0; lower<=1; lower++){
+        b.setLowercase(lower);
+
+        glyphIs(b, " ", 0, 1);
+        glyphIs(b, "A", 'A' - 32, 1);
+        glyphIs(b, "`", '`' - 32, 1);
+        glyphIs(b, "a", lower ? FONT_LOWER : 'A' - 32, 1);
+        glyphIs(b, "z", lower ? FONT_LOWER + 25 : 'Z' - 32, 1);
+        glyphIs(b, "{", FONT_BRACES, 1);
+        glyphIs(b, "|", FONT_BRACES + 1, 1);
+        glyphIs(b, "}", FONT_BRACES + 2, 1);
+        glyphIs(b, "~", FONT_BRACES + 3, 1);
+
+        // two byte sequences: é has an uppercase glyph, ß and à do not
+        glyphIs(b, "\xC3\x89", FONT_LATIN + 6, 2);
+        glyphIs(b, "\xC3\xA9", lower ? FONT_LATIN + 15 : FONT_LATIN + 6, 2);
+        glyphIs(b, "\xC3\x9F", FONT_LATIN + 10, 2);
+        glyphIs(b, "\xC3\xA0", FONT_LATIN + 11, 2);
+        glyphIs(b, "\xC2\xA1", FONT_LATIN, 2);
+        glyphIs(b, "\xC3\xBC" "A", lower ? FONT_LATIN + 18 : FONT_LATIN + 9, 2);
+
+        // characters the font does not have
+        glyphIs(b, "\xC2\xA5", FONT_FALLBACK, 2);
+        glyphIs(b, "\xC3\xBF", FONT_FALLBACK, 2);
+        glyphIs(b, "\xE2\x82\xAC", FONT_FALLBACK, 3);
+        glyphIs(b, "\xF0\x9F\x98\x80", FONT_FALLBACK, 4);
+
+        // control characters
+        glyphIs(b, "\x01", FONT_FALLBACK, 1);
+        glyphIs(b, "\t", FONT_FALLBACK, 1);
+        glyphIs(b, "\x7F", FONT_FALLBACK, 1);
+
+        // truncated sequences stop at the byte that does not continue them
+        glyphIs(b, "\xC3", FONT_FALLBACK, 1);
+        glyphIs(b, "\xC3" "A", FONT_FALLBACK, 1);
+        glyphIs(b, "\xE2\x82", FONT_FALLBACK, 2);
+        glyphIs(b, "\xE3\x84", FONT_FALLBACK, 2);
+        glyphIs(b, "\xF0\x9F\x98" "A", FONT_FALLBACK, 3);
+
+        // invalid bytes
+        glyphIs(b, "\x80", FONT_FALLBACK, 1);
+        glyphIs(b, "\xBF" "A", FONT_FALLBACK, 1);
+        glyphIs(b, "\xF8\x80", FONT_FALLBACK, 1);
+        glyphIs(b, "\xFF", FONT_FALLBACK, 1);
+    }
+
+    // the glyphs reach the frames
+    b.setLowercase(true);
+    printsGlyph(b, "\xC3\xA9", FONT_LATIN + 15);
+    printsGlyph(b, "a", FONT_LOWER);
+    printsGlyph(b, "~", FONT_BRACES + 3);
+    printsGlyph(b, "\xE2\x82\xAC", FONT_FALLBACK);
+    b.setLowercase(false);
+    printsGlyph(b, "\xC3\xA9", FONT_LATIN + 6);
+
+    printf("%s\n", failed ? "FAILED" : "ok");
+    return failed ? 1 : 0;
+
+}
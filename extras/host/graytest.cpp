@@ -0,0 +1,146 @@
+/*
+    Checks the PWM registers behind setBrightness(), setDimmer() and the
+    effects, with and without kept gray levels, and after a reset of the
+    beams.
+*/
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "beam.h"
+#include "as1130.h"
+
+static const uint8_t addresses[4] = {BEAMA, BEAMB, BEAMC, BEAMD};
+static int failed = 0;
+
+#define CHECK(cond) do { if (!(cond)){ printf("%s:%d: %s\n", __FILE__, __LINE__, #cond); failed++; } } while (0)
+
+//PWM value of level after the dimmer, gamma 2.2 with lit levels kept lit
+static uint8_t pwmValue(uint8_t level, uint8_t dimmer){
+    int v = (level * dimmer + 127) / 255;
+    return v ? (uint8_t)fmax(1, lround(255 * pow(v / 255.0, 2.2))) : 0;
+}
+
+static void run(Beam &b, unsigned long ms){
+    uint64_t end = sim.now + 1000000ULL * ms;
+    while (sim.now < end){
+        b.poll();
+        sim.advance(1000);
+    }
+}
+
+//LEDs of the blink region from column 22 to 24 and row 1 to 3 that are
+//not off, and LEDs outside it not at full level
+static int wrongBlink(int beams){
+    int wrong = 0;
+    for (int n=0; n<beams; n++){
+        AS1130 *c = sim.chip(addresses[n]);
+        for (uint8_t row=0; row<5; row++){
+            for (uint8_t col=0; col<24; col++){
+                bool inside = 24*n + col >= 22 && 24*n + col <= 24 && row >= 1 && row <= 3;
+                if (c->ledPwm(0, col, row) != (inside ? 0 : 255)){
+                    wrong++;
+                }
+            }
+        }
+    }
+    return wrong;
+}
+
+static uint8_t brightest(int beams){
+    uint8_t pwm = 0;
+    for (int n=0; n<beams; n++){
+        for (uint8_t i=0; i<AS1130_PWM; i++){
+            if (i % 11 < 10 && sim.chip(addresses[n])->pwm[0][i] > pwm){
+                pwm = sim.chip(addresses[n])->pwm[0][i];
+            }
+        }
+    }
+    return pwm;
+}
+
+//LEDs of the chain whose PWM register is not what level and dimmer give,
+//except the one LED at x, y which has to be at its own level
+static int wrongLeds(int beams, uint8_t dimmer, int x, int y, uint8_t level){
+    int wrong = 0;
+    for (int n=0; n<beams; n++){
+        AS1130 *c = sim.chip(addresses[n]);
+        for (uint8_t row=0; row<5; row++){
+            for (uint8_t col=0; col<24; col++){
+                bool own = (24*n + col == x && row == y);
+                if (c->ledPwm(0, col, row) != pwmValue(own ? level : 255, dimmer)){
+                    wrong++;
+                }
+            }
+        }
+    }
+    return wrong;
+}
+
+int main(){
+
+    for (int beams=1; beams<=4; beams++){
+        Beam b = Beam(5, 9, beams);
+        b.begin();
+        b.setSoftReplace(false);
+        b.printStatic("GRAY");
+
+        // one LED of the last beam
+        int x = 24*(beams - 1) + 5;
+        CHECK(b.setBrightness(x, 2, 100) == BEAM_OK);
+        CHECK(wrongLeds(beams, 255, x, 2, 100) == 0);
+
+        // the dimmer always reaches the beams
+        sim.clearCounters();
+        CHECK(b.setDimmer(128) == BEAM_OK);
+        CHECK(sim.transactions >= (uint32_t)beams);
+        #if BEAM_GRAY_BEAMS
+        CHECK(wrongLeds(beams, 128, x, 2, 100) == 0);
+        #else
+        // without kept levels the LED falls back to 255
+        CHECK(wrongLeds(beams, 128, -1, 0, 255) == 0);
+        #endif
+
+        // a message without soft replace resets the beams, the dimmer
+        // and kept levels come back
+        CHECK(b.print("Hello") == BEAM_OK);
+        #if BEAM_GRAY_BEAMS
+        CHECK(wrongLeds(beams, 128, x, 2, 100) == 0);
+        #else
+        CHECK(wrongLeds(beams, 128, -1, 0, 255) == 0);
+        #endif
+
+        CHECK(b.setDimmer(255) == BEAM_OK);
+        CHECK(b.setBrightness(x, 2, 255) == BEAM_OK);
+        CHECK(wrongLeds(beams, 255, -1, 0, 255) == 0);
+
+        // half way into a breath every beam is dark
+        CHECK(b.breathe(2000) == BEAM_OK);
+        run(b, 1000);
+        CHECK(brightest(beams) <= 2);
+        CHECK(b.stopEffect() == BEAM_OK);
+        CHECK(wrongLeds(beams, 255, -1, 0, 255) == 0);
+
+        // the region is off every other period
+        CHECK(b.blink(22, 1, 24, 3, 500) == BEAM_OK);
+        run(b, 750);
+        CHECK(wrongBlink(beams) == 0);
+        CHECK(b.stopEffect() == BEAM_OK);
+        CHECK(wrongLeds(beams, 255, -1, 0, 255) == 0);
+
+        // a crossfade dips through black and comes back with the new text
+        CHECK(b.setDimmer(200) == BEAM_OK);
+        CHECK(b.crossfade("NEW", 1000) == BEAM_OK);
+        run(b, 500);
+        CHECK(brightest(beams) <= 2);
+        for (int i=0; i<50 && b.effectRunning(); i++){
+            run(b, 100);
+        }
+        CHECK(!b.effectRunning());
+        CHECK(wrongLeds(beams, 200, -1, 0, 255) == 0);
+        CHECK(b.setDimmer(255) == BEAM_OK);
+    }
+
+    printf("%s\n", failed ? "FAILED" : "ok");
+    return failed ? 1 : 0;
+
+}
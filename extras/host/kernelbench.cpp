@@ -0,0 +1,61 @@
+/*
+    Times packFrame() against the shift loops of the old convertFrame(),
+    over the frames of draw() and random bitmaps. packFrame() comes with
+    the engine in beamchain.h.
+*/
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "beam.h"
+#include "oldconvert.h"
+
+#include <chrono>
+
+#define ROUNDS 2000000
+
+static const uint8_t frameList[36][15] = OLD_FRAME_LIST;
+static uint8_t bitmaps[64][15];
+volatile uint16_t sink;
+
+template <class Convert>
+static double nanosPerFrame(Convert convert){
+    double best = 1e9;
+    for (int k=0; k<5; k++){
+        std::chrono::steady_clock::time_point t = std::chrono::steady_clock::now();
+        convert();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t).count() / ROUNDS;
+        if (ns < best){
+            best = ns;
+        }
+    }
+    return best;
+}
+
+int main(){
+
+    for (uint8_t i=0; i<64; i++){
+        for (uint8_t k=0; k<15; k++){
+            bitmaps[i][k] = (i < 36) ? frameList[i][k] : rand() & 0xFF;
+        }
+    }
+
+    OldConvert old;
+    double before = nanosPerFrame([&]{
+        for (long r=0; r<ROUNDS; r++){
+            old.convertFrameFromRAM(bitmaps[r & 63]);
+            sink = old.cs[r % 12];
+        }
+    });
+    uint16_t cs[12];
+    double after = nanosPerFrame([&]{
+        for (long r=0; r<ROUNDS; r++){
+            packFrame(cs, RamSource(bitmaps[r & 63]));
+            sink = cs[r % 12];
+        }
+    });
+
+    printf("convertFrame shift loops %6.1f ns/frame\n", before);
+    printf("packFrame                %6.1f ns/frame, %.1fx\n", after, before / after);
+    return 0;
+
+}
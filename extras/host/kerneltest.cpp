@@ -0,0 +1,67 @@
+/*
+    Checks that the frames the library uploads are bit identical to what
+    the shift loops of the old convertFrame() produced, for every frame of
+    draw() and for random bitmaps sent through loadFrameFromRAM().
+*/
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "beam.h"
+#include "frames.h"
+#include "as1130.h"
+#include "oldconvert.h"
+
+static const uint8_t frameList[36][15] = OLD_FRAME_LIST;
+
+static int failed = 0;
+
+static void compare(const char *what, long index, const uint8_t *bitmap, const uint8_t *regs){
+    OldConvert old;
+    uint8_t expected[24];
+    old.convertFrameFromRAM(bitmap);
+    old.registers(expected);
+    if (memcmp(expected, regs, 24) != 0){
+        if (failed++ < 10){
+            printf("%s %ld differs\n", what, index);
+        }
+    }
+}
+
+int main(){
+
+    // the images draw() sends, encoded at compile time
+    for (uint8_t f=0; f<36; f++){
+        uint8_t regs[24];
+        memcpy_P(regs, frameImages[f], 24);
+        compare("frameImages", f, frameList[f], regs);
+    }
+
+    Beam b = Beam(5, 9, 1);
+    b.begin();
+
+    // what draw() leaves in frame memory
+    b.draw();
+    AS1130 *c = sim.chip(BEAMA);
+    for (uint8_t f=0; f<36; f++){
+        compare("draw frame", f, frameList[f], c->frame[f]);
+    }
+
+    // the runtime kernel behind loadFrameFromRAM()
+    for (uint8_t f=0; f<36; f++){
+        b.loadFrameFromRAM(BEAMA, f, (uint8_t *)frameList[f]);
+        compare("frameList", f, frameList[f], c->frame[f]);
+    }
+    srand(1);
+    for (long i=0; i<100000; i++){
+        uint8_t bitmap[15];
+        for (uint8_t k=0; k<15; k++){
+            bitmap[k] = rand() & 0xFF;
+        }
+        b.loadFrameFromRAM(BEAMA, i % 36, bitmap);
+        compare("random bitmap", i, bitmap, c->frame[i % 36]);
+    }
+
+    printf("%s\n", failed ? "FAILED" : "ok");
+    return failed ? 1 : 0;
+
+}
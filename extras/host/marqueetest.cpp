@@ -0,0 +1,136 @@
+/*
+    Checks marquee() frame by frame: a message far longer than the 36
+    frames of print() scrolls through the frame ring, and every frame each
+    beam shows is compared with a rendering of the text made here from the
+    font, in single beam mode and on chains of 1 to 4 beams. Once the text
+    has scrolled off the beams stay blank.
+*/
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "beam.h"
+#include "as1130.h"
+#include "charactermap.h"
+
+static const uint8_t addresses[4] = {BEAMA, BEAMB, BEAMC, BEAMD};
+static int failed = 0;
+
+static char text[2048];
+static uint8_t columns[2048 * 6];
+static uint32_t columnCount;
+
+//the message and its columns, the text only uses glyphs from SPACE to `
+static void render(){
+    static const char *words[] = {"THE", "QUICK", "BROWN", "FOX", "JUMPS", "OVER", "THE", "LAZY", "DOG", "0123456789", "!?.,:;-+=@#"};
+    uint16_t length = 0;
+    for (int w=0; length < 1900; w = (w + 1) % 11){
+        for (const char *p = words[w]; *p; p++){
+            text[length++] = *p;
+        }
+        text[length++] = ' ';
+    }
+    text[length] = 0;
+
+    columnCount = 0;
+    for (uint16_t i=0; i<length; i++){
+        uint8_t glyph = text[i] - 32;
+        for (uint16_t k=pgm_read_word_near(&fontOffsets[glyph]); k<pgm_read_word_near(&fontOffsets[glyph + 1]); k++){
+            columns[columnCount++] = pgm_read_byte_near(&fontColumns[k]);
+        }
+    }
+}
+
+//whether frame f of the chip holds text frame index, blank outside the text
+static bool showsFrame(const AS1130 *c, uint8_t f, int32_t index){
+    for (uint8_t x=0; x<24; x++){
+        int64_t column = (int64_t)index * 24 + x;
+        uint8_t bits = (index >= 0 && column < columnCount) ? columns[column] : 0;
+        for (uint8_t y=0; y<5; y++){
+            if (c->led(f, x, y) != ((bits >> y) & 1)){
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void scroll(Beam &b, int beams, const char *name){
+
+    b.begin();
+    if (b.marquee(text, 1) != BEAM_OK){
+        printf("%s: marquee() failed\n", name);
+        failed++;
+        return;
+    }
+
+    uint32_t frames = (columnCount + 23) / 24;
+    uint32_t checked[4] = {0, 0, 0, 0};
+    int32_t last[4] = {-1, -1, -1, -1};
+    uint64_t start = sim.micros();
+    while (b.streaming() && sim.micros() - start < 30000000ULL){
+        b.poll();
+        sim.advance(1000);
+        for (int n=0; n<beams; n++){
+            AS1130 *c = sim.chip(addresses[n]);
+            if (!(c->control[SHDN] & 1) || !(c->control[MOV] & 0x40)){
+                continue;
+            }
+            int32_t step = c->movieSteps(sim.now);
+            if (step == last[n]){
+                continue;
+            }
+            last[n] = step;
+            // beam n runs frameOffset() = beams - n frames behind the stream
+            int32_t index = step - (beams - n);
+            if (!showsFrame(c, c->frameOnShow(sim.now), index)){
+                if (failed < 10){
+                    printf("%s: beam %d shows the wrong frame at stream frame %ld, text frame %ld\n", name, n, (long)step, (long)index);
+                    sim.dumpFrame(stdout, addresses[n]);
+                }
+                failed++;
+            }
+            checked[n]++;
+        }
+    }
+
+    if (b.streaming()){
+        printf("%s: still scrolling after 30 s\n", name);
+        failed++;
+    }
+    if (b.streamUnderruns() != 0){
+        printf("%s: %u underruns\n", name, b.streamUnderruns());
+        failed++;
+    }
+    for (int n=0; n<beams; n++){
+        // the last frame shown is the blank one after the text
+        if (checked[n] < frames){
+            printf("%s: beam %d showed %lu of %lu text frames\n", name, n, (unsigned long)checked[n], (unsigned long)frames);
+            failed++;
+        }
+        AS1130 *c = sim.chip(addresses[n]);
+        if (c->frameOnShow(sim.now) < 0 || !showsFrame(c, c->frameOnShow(sim.now), -1)){
+            printf("%s: beam %d is not left blank\n", name, n);
+            failed++;
+        }
+    }
+
+}
+
+int main(){
+
+    render();
+
+    Beam single = Beam(5, 9, 0, BEAMA);
+    scroll(single, 1, "single");
+
+    for (int beams=1; beams<=4; beams++){
+        char name[16];
+        snprintf(name, sizeof(name), "%d beams", beams);
+        Beam b = Beam(5, 9, beams);
+        scroll(b, beams, name);
+    }
+
+    printf("%s\n", failed ? "FAILED" : "ok");
+    return failed ? 1 : 0;
+
+}
@@ -0,0 +1,113 @@
+/*
+    convertFrameFromRAM() as it was before packFrame(), kept as the
+    reference the kernel is checked against. Copied from the library
+    unchanged, except that cs[] is cleared first, as draw() did between
+    frames.
+*/
+
+#ifndef _HOST_OLDCONVERT
+#define _HOST_OLDCONVERT
+
+#include <stdint.h>
+
+struct OldConvert {
+    uint16_t cs[12], segmentmask[8];
+
+    OldConvert(){
+        //reset segmentmask[]
+        uint8_t val = 0x80;
+        int s = 0;
+        for (s=0; s<8; s++){
+            segmentmask[s] = val;
+            val = val/2;
+        }
+    }
+
+    // convert a frame stored in RAM as a 15 (3x5) byte array
+    void convertFrameFromRAM(const uint8_t *pFrameData){
+        for (int c=0; c<12; c++){
+            cs[c] = 0x00;
+        }
+
+        int i=0;
+
+        //CS0 to CS3
+        int n=0;
+        for (int y=10; y>0; --y){
+
+            if (y < 6){
+                i=1;
+            } else {
+                i=0;
+            }
+            cs[0] = cs[0] | (((*(pFrameData + n) & segmentmask[0+i]) <<(3+i)) >> y);
+            cs[1] = cs[1] | (((*(pFrameData + n) & segmentmask[2+i]) <<(5+i)) >> y);
+            cs[2] = cs[2] | (((*(pFrameData + n) & segmentmask[4+i]) <<(7+i)) >> y);
+            cs[3] = cs[3] | (((*(pFrameData + n) & segmentmask[6+i]) <<(9+i)) >> y);
+            n=n+3;
+
+            if (n>12){
+                n = 0;
+            }
+
+        }
+
+        //CS4 to CS7
+        n = 1;
+        for (int y=10; y>0; --y){
+
+            if (y < 6){
+                i=1;
+            } else {
+                i=0;
+            }
+            cs[4] = cs[4] | (((*(pFrameData + n) & segmentmask[0+i]) <<(3+i)) >> y);
+            cs[5] = cs[5] | (((*(pFrameData + n) & segmentmask[2+i]) <<(5+i)) >> y);
+            cs[6] = cs[6] | (((*(pFrameData + n) & segmentmask[4+i]) <<(7+i)) >> y);
+            cs[7] = cs[7] | (((*(pFrameData + n) & segmentmask[6+i]) <<(9+i)) >> y);
+            n=n+3;
+
+            if (n>13){
+                n = 1;
+            }
+        }
+
+        //CS8 - CS11
+        n = 2;
+        for (int y=10; y>0; --y){
+
+            if (y < 6){
+                i=1;
+            } else {
+                i=0;
+            }
+            cs[8] = cs[8]   | (((*(pFrameData + n) & segmentmask[0+i]) <<(3+i)) >> y);
+            cs[9] = cs[9]   | (((*(pFrameData + n) & segmentmask[2+i]) <<(5+i)) >> y);
+            cs[10] = cs[10] | (((*(pFrameData + n) & segmentmask[4+i]) <<(7+i)) >> y);
+            cs[11] = cs[11] | (((*(pFrameData + n) & segmentmask[6+i]) <<(9+i)) >> y);
+            n=n+3;
+
+            if (n>14){
+                n = 2;
+            }
+        }
+    }
+
+    //the frame registers writeFrame() sent for cs[]
+    void registers(uint8_t *regs) const {
+        for (int j=0; j<12; j++){
+            regs[2*j] = cs[j] & 0xFF;
+            regs[2*j+1] = (cs[j] & 0x300) >> 8;
+        }
+    }
+};
+
+//The bitmaps of draw(), frameList before they were encoded at compile time
+#define OLD_FRAME_LIST { \
+    frame0, frame1, frame2, frame3, frame4, frame5, frame6, frame7, frame8, \
+    frame9, frame10, frame11, frame12, frame13, frame14, frame15, frame16, frame17, \
+    frame18, frame19, frame20, frame21, frame22, frame23, frame24, frame25, frame26, \
+    frame27, frame28, frame29, frame30, frame31, frame32, frame33, frame34, frame35 \
+}
+
+#endif
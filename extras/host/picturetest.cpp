@@ -0,0 +1,77 @@
+/*
+    Checks that a movie started after any call that shows a picture
+    clears the picture bit of PIC, otherwise the beams keep showing the
+    picture instead of the movie.
+*/
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "beam.h"
+#include "as1130.h"
+
+static const uint8_t addresses[4] = {BEAMA, BEAMB, BEAMC, BEAMD};
+static int failed = 0;
+
+static bool shortStream(uint32_t index, uint8_t beam, uint8_t *frame){
+    memset(frame, 0x55, 15);
+    return index < 40;
+}
+
+static void moviePlays(const char *after, int beams){
+    for (int n=0; n<beams; n++){
+        AS1130 *c = sim.chip(addresses[n]);
+        if ((c->control[PIC] & 0x40) || !(c->control[MOV] & 0x40)){
+            printf("%s on %d beams: beam %d has PIC %02X, MOV %02X\n", after, beams, n, c->control[PIC], c->control[MOV]);
+            failed++;
+        }
+    }
+}
+
+int main(){
+
+    for (int beams=1; beams<=4; beams++){
+        Beam b = Beam(5, 9, beams);
+        b.begin();
+        // configure the beams first, so that print() does not reset them
+        b.print("Hello");
+        b.play();
+
+        b.display(3);
+        b.print("Hello");
+        b.play();
+        moviePlays("display()", beams);
+
+        b.printStatic("Hi");
+        b.print("Hello");
+        b.play();
+        moviePlays("printStatic()", beams);
+
+        b.printStatic("Hi");
+        b.flip();
+        b.print("Hello");
+        b.play();
+        moviePlays("flip()", beams);
+
+        // the last frame of a stream is held as a picture
+        b.stream(shortStream, 1);
+        while (b.streaming()){
+            b.poll();
+            sim.advance(1000);
+        }
+        b.print("Hello");
+        b.play();
+        moviePlays("stream()", beams);
+
+        // a picture after a picture is still set up in full
+        b.display(3);
+        b.printStatic("Hi");
+        if ((sim.chip(BEAMA)->control[PIC] & 0x3F) != (b.backFrame() ^ 1)){
+            printf("printStatic() after display() on %d beams shows frame %d\n", beams, sim.chip(BEAMA)->control[PIC] & 0x3F);
+            failed++;
+        }
+    }
+
+    printf("%s\n", failed ? "FAILED" : "ok");
+    return failed ? 1 : 0;
+
+}
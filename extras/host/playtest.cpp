@@ -0,0 +1,80 @@
+/*
+    Checks the chained playback hand-off: after play() every beam of the
+    chain runs, started one after the other in the scroll direction, with
+    the IRQ pin and without it, within a bounded time.
+*/
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "beam.h"
+#include "as1130.h"
+
+static const uint8_t addresses[4] = {BEAMA, BEAMB, BEAMC, BEAMD};
+static int failed = 0;
+
+#define LIMIT_MICROS 2000000
+
+static void handOff(int beams, uint8_t direction, int irqpin){
+
+    const char *name = (direction == LEFT) ? "LEFT" : "RIGHT";
+    Beam b = Beam(5, irqpin, beams);
+    b.begin();
+    b.print("HANDOFF");
+    b.setScroll(direction, FADEOFF);
+
+    // the order the beams start in, polled until every beam runs
+    int order[4];
+    int started = 0;
+    uint64_t start = sim.micros();
+    b.playAsync();
+    while (started < beams && sim.micros() - start < LIMIT_MICROS){
+        for (int n=0; n<beams; n++){
+            bool running = sim.chip(addresses[n])->control[SHDN] & 1;
+            bool seen = false;
+            for (int i=0; i<started; i++){
+                seen = seen || order[i] == n;
+            }
+            if (running && !seen){
+                order[started++] = n;
+            }
+        }
+        b.poll();
+        sim.advance(100);
+    }
+
+    if (started < beams){
+        printf("%s on %d beams, IRQ pin %d: %d beams running after %d ms\n", name, beams, irqpin, started, LIMIT_MICROS / 1000);
+        failed++;
+        return;
+    }
+    for (int i=0; i<beams; i++){
+        int expect = (direction == LEFT) ? beams - 1 - i : i;
+        if (order[i] != expect){
+            printf("%s on %d beams, IRQ pin %d: beam %d started %d-th\n", name, beams, irqpin, order[i], i + 1);
+            failed++;
+        }
+    }
+
+    // play() itself returns once the hand-off is done
+    start = sim.micros();
+    b.play();
+    if (sim.micros() - start > LIMIT_MICROS){
+        printf("%s on %d beams, IRQ pin %d: play() took %lu ms\n", name, beams, irqpin, (unsigned long)(sim.micros() - start) / 1000);
+        failed++;
+    }
+
+}
+
+int main(){
+
+    for (int beams=1; beams<=4; beams++){
+        for (int irqpin=2; irqpin<=9; irqpin+=7){
+            handOff(beams, LEFT, irqpin);
+            handOff(beams, RIGHT, irqpin);
+        }
+    }
+
+    printf("%s\n", failed ? "FAILED" : "ok");
+    return failed ? 1 : 0;
+
+}
@@ -0,0 +1,60 @@
+/*
+    Worst case latency of one poll() while an asynchronous upload runs,
+    for chains of 1 to 4 beams at 100 kHz and 400 kHz: the most I2C
+    transactions, bytes and bus time a single poll() spent, with the
+    default transaction budget. Also checks that the progress poll()
+    reports never goes back.
+*/
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "beam.h"
+#include "as1130.h"
+
+static const char *jobNames[4] = {"print long", "print short", "draw", "printStatic"};
+
+int main(){
+
+    int failed = 0;
+    printf("beams  clock  job          polls  max tx  max bytes  max us\n");
+
+    for (uint32_t clockHz = 100000; clockHz <= 400000; clockHz *= 4){
+        for (int beams=1; beams<=4; beams++){
+            Beam b = Beam(5, 9, beams);
+            b.begin();
+            b.setBusClock(clockHz);
+            for (int job=0; job<4; job++){
+                switch (job){
+                    case 0: b.printAsync("This is an example of fast scrolling text on Beam. "); break;
+                    case 1: b.printAsync("Hi"); break;
+                    case 2: b.drawAsync(); break;
+                    case 3: b.printStaticAsync("Beam"); break;
+                }
+                uint32_t polls = 0, maxTransactions = 0, maxBytes = 0;
+                uint64_t maxNanos = 0;
+                int last = 0;
+                uint8_t progress;
+                do {
+                    uint32_t transactions = sim.transactions, bytes = sim.bytes;
+                    uint64_t busNanos = sim.busNanos;
+                    progress = b.poll();
+                    polls++;
+                    if (sim.transactions - transactions > maxTransactions) maxTransactions = sim.transactions - transactions;
+                    if (sim.bytes - bytes > maxBytes) maxBytes = sim.bytes - bytes;
+                    if (sim.busNanos - busNanos > maxNanos) maxNanos = sim.busNanos - busNanos;
+                    if (progress < last){
+                        printf("progress went back from %d to %d\n", last, progress);
+                        failed++;
+                    }
+                    last = progress;
+                    sim.advance(100);
+                } while (progress < 100);
+
+                printf("%5d  %3lu k  %-11s  %5lu  %6lu  %9lu  %6lu\n", beams, (unsigned long)clockHz / 1000, jobNames[job],
+                    (unsigned long)polls, (unsigned long)maxTransactions, (unsigned long)maxBytes, (unsigned long)(maxNanos / 1000));
+            }
+        }
+    }
+    return failed ? 1 : 0;
+
+}
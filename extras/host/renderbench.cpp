@@ -0,0 +1,48 @@
+/*
+    Render throughput of print(): characters per second packed into
+    register words by renderFrame(), without any I2C traffic.
+*/
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "as1130.h"
+
+#include <chrono>
+
+// renderFrame() and its cursor are private, the benchmark drives them directly
+#define private public
+#include "beam.h"
+#undef private
+
+#define ROUNDS 200000
+
+int main(){
+
+    static const char text[] = "The quick brown fox jumps over the lazy dog. "
+                               "Pack my box with five dozen liquor jugs. 0123456789";
+    Beam b = Beam(5, 9, 1);
+    size_t length = strlen(text);
+
+    double best = 0;
+    uint32_t frames = 0;
+    for (int k=0; k<5; k++){
+        frames = 0;
+        std::chrono::steady_clock::time_point t = std::chrono::steady_clock::now();
+        for (long r=0; r<ROUNDS; r++){
+            b._jobText = text;
+            b._jobPos = 0;
+            b._jobCol = 0;
+            do {
+                frames++;
+            } while (b.renderFrame());
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t).count();
+        if (ROUNDS * length / seconds > best){
+            best = ROUNDS * length / seconds;
+        }
+    }
+
+    printf("render %.1f M characters/s, %lu frames per text\n", best / 1e6, (unsigned long)(frames / ROUNDS));
+    return 0;
+
+}
@@ -0,0 +1,224 @@
+/*
+    Checks the simulator against the library: the I2C traffic both count,
+    the frames print() leaves in frame memory and the frame status
+    register following a movie, retries, offline beams and their recovery
+    after failed writes and reads, that a chain without beams stays off
+    the bus, and who owns the IRQ.
+*/
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "beam.h"
+#include "as1130.h"
+
+static int failed = 0;
+
+#define CHECK(cond) do { if (!(cond)){ printf("%s:%d: %s\n", __FILE__, __LINE__, #cond); failed++; } } while (0)
+
+static bool frameIs(uint8_t address, uint8_t f, const char *rows){
+    AS1130 *c = sim.chip(address);
+    for (uint8_t y=0; y<5; y++){
+        for (uint8_t x=0; x<24; x++){
+            if (c->led(f, x, y) != (rows[25 * y + x] == '#')){
+                sim.dumpFrame(stdout, address, f);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool blankSource(uint32_t index, uint8_t beam, uint8_t *frame){
+    memset(frame, 0, 15);
+    return index < 10;
+}
+
+//the text of print("HI") in frame 1 of the chip
+static bool showsHi(uint8_t address){
+    return frameIs(address, 1,
+        "#..#.###................\n"
+        "#..#..#.................\n"
+        "####..#.................\n"
+        "#..#..#.................\n"
+        "#..#.###................\n");
+}
+
+/*
+    Makes the next attempts on the second beam of a chain fail with status,
+    first one short of taking it offline, which the retries have to absorb,
+    then enough to take it offline. The next print() has to bring it back.
+*/
+static void writeFault(uint8_t status){
+
+    Beam b = Beam(5, 9, 2);
+    b.begin();
+    CHECK(b.print("HI") == BEAM_OK);
+
+    uint32_t restarts = sim.busRestarts;
+    sim.failAddress = BEAMB;
+    sim.failStatus = status;
+    sim.failCount = BEAM_I2C_RETRIES;
+    CHECK(b.setSpeed(2) == BEAM_OK);
+    CHECK(sim.failCount == 0);
+    CHECK(b.beamOnline(BEAMB));
+    CHECK(b.errorCount(BEAMB) == BEAM_I2C_RETRIES);
+
+    sim.failCount = BEAM_I2C_RETRIES + 1;
+    CHECK(b.setSpeed(3) == status);
+    CHECK(sim.failCount == 0);
+    CHECK(!b.beamOnline(BEAMB));
+    CHECK(b.beamOnline(BEAMA));
+    CHECK(b.errorCount(BEAMB) == 2 * BEAM_I2C_RETRIES + 1);
+    CHECK(b.errorCount(BEAMA) == 0);
+    CHECK(b.lastError() == status);
+    // a timeout or bus error frees the bus before every retry
+    if (status == BEAM_ERR_TIMEOUT){
+        CHECK(sim.busRestarts - restarts == 2 * BEAM_I2C_RETRIES + 1);
+    } else {
+        CHECK(sim.busRestarts == restarts);
+    }
+
+    // an offline beam is skipped, the other one still gets its writes
+    sim.failCount = 0;
+    uint32_t transactions = sim.transactions;
+    CHECK(b.setSpeed(4) != BEAM_OK);
+    CHECK(sim.transactions - transactions == 1);
+    CHECK((sim.chip(BEAMA)->control[FRAMETIME] & 0x0F) == 4);
+
+    // the next print() resets the beams and brings the beam back
+    b.clearErrors();
+    CHECK(b.print("HI") == BEAM_OK);
+    CHECK(b.beamOnline(BEAMB));
+    CHECK(b.errorCount(BEAMB) == 0);
+    CHECK(showsHi(BEAMB));
+    sim.failAddress = 0xFF;
+    sim.failStatus = 2;
+
+}
+
+int main(){
+
+    Beam b = Beam(5, 9, 1);
+    CHECK(b.begin());
+
+    sim.clearCounters();
+    b.clearStats();
+    CHECK(b.print("HI") == BEAM_OK);
+    BeamStats s = b.getStats();
+    CHECK(s.transactions == sim.transactions);
+    CHECK(s.bytes == sim.bytes);
+    CHECK(sim.nacks == 0 && sim.overflows == 0 && sim.strayWrites == 0);
+    CHECK(b.busMicros(100000) == (uint32_t)(sim.busNanos / 1000));
+    CHECK(b.busMicros(0) == 0);
+
+    AS1130 *c = sim.chip(BEAMA);
+    CHECK(c->control[MOV] == (1 << 6));
+    CHECK(frameIs(BEAMA, 1,
+        "#..#.###................\n"
+        "#..#..#.................\n"
+        "####..#.................\n"
+        "#..#..#.................\n"
+        "#..#.###................\n"));
+
+    // the status register counts movie frames once the beam plays
+    CHECK(b.play() == BEAM_OK);
+    CHECK(c->frameOnShow(sim.now) == 0);
+    delay((c->control[FRAMETIME] & 0x0F) * AS1130_FRAME_MICROS / 1000 + 1);
+    Wire.beginTransmission(BEAMA);
+    Wire.write(REGSEL);
+    Wire.write(CTRL);
+    CHECK(Wire.endTransmission() == 0);
+    Wire.beginTransmission(BEAMA);
+    Wire.write(0x0F);
+    CHECK(Wire.endTransmission() == 0);
+    CHECK(Wire.requestFrom(BEAMA, 1) == 1);
+    CHECK(Wire.read() >> 2 == 1);
+
+    // stream() needs a source
+    sim.clearCounters();
+    CHECK(b.stream(0, 1) == BEAM_ERR_ARGUMENT);
+    CHECK(!b.streaming());
+    CHECK(b.poll() == 100);
+    CHECK(sim.transactions == 0);
+
+    // a missing beam does not acknowledge
+    sim.detach(BEAMA);
+    CHECK(b.setSpeed(2) == BEAM_ERR_NACK_ADDR);
+    CHECK(sim.nacks > 0);
+    sim.defaults();
+
+    // failed writes are retried, then take the beam offline until a reset
+    writeFault(BEAM_ERR_NACK_ADDR);
+    writeFault(BEAM_ERR_NACK_DATA);
+    writeFault(BEAM_ERR_TIMEOUT);
+
+    // so is a failed status read
+    Beam single = Beam(5, 9, 0, BEAMA);
+    single.begin();
+    CHECK(single.print("HI") == BEAM_OK);
+    CHECK(single.play() == BEAM_OK);
+    sim.readFailures = BEAM_I2C_RETRIES;
+    CHECK(single.status() >= 0);
+    CHECK(single.beamOnline(BEAMA));
+    sim.readFailures = BEAM_I2C_RETRIES + 1;
+    CHECK(single.status() == -1);
+    CHECK(sim.readFailures == 0);
+    CHECK(!single.beamOnline(BEAMA));
+    CHECK(single.errorCount(BEAMA) == 2 * BEAM_I2C_RETRIES + 1);
+    CHECK(single.lastError() == BEAM_ERR_READ);
+    CHECK(single.status() == -1);
+    CHECK(single.print("HI") == BEAM_OK);
+    CHECK(single.beamOnline(BEAMA));
+    CHECK(single.status() >= 0);
+    CHECK(showsHi(BEAMA));
+
+    // a chain of no beams, or of more than BEAM_MAX_BEAMS, refuses uploads
+    // instead of writing to the general call address
+    for (int count=0; count<=BEAM_MAX_BEAMS + 1; count += BEAM_MAX_BEAMS + 1){
+        Beam none = Beam(5, 9, count);
+        none.begin();
+        sim.clearCounters();
+        CHECK(none.print("HI") == BEAM_ERR_ARGUMENT);
+        CHECK(none.printAsync("HI") == BEAM_ERR_ARGUMENT);
+        CHECK(none.poll() == 100);
+        CHECK(none.printStatic("HI") == BEAM_ERR_ARGUMENT);
+        CHECK(none.draw() == BEAM_ERR_ARGUMENT);
+        CHECK(none.stream(blankSource, 1) == BEAM_ERR_ARGUMENT);
+        CHECK(none.marquee("HI", 1) == BEAM_ERR_ARGUMENT);
+        CHECK(!none.streaming());
+        CHECK(sim.transactions == 0);
+    }
+
+    // an address table longer than BEAM_MAX_BEAMS is refused as a whole
+    uint8_t tableAddresses[BEAM_MAX_BEAMS + 1], tableChannels[BEAM_MAX_BEAMS + 1];
+    for (int n=0; n<=BEAM_MAX_BEAMS; n++){
+        static const uint8_t chain[4] = {BEAMA, BEAMB, BEAMC, BEAMD};
+        tableAddresses[n] = chain[n % 4];
+        tableChannels[n] = n / 4;
+    }
+    Beam table = Beam(5, 9, BEAM_MAX_BEAMS + 1, tableAddresses, tableChannels);
+    sim.clearCounters();
+    CHECK(!table.begin());
+    CHECK(table.initBeam() == BEAM_ERR_ARGUMENT);
+    CHECK(table.print("HI") == BEAM_ERR_ARGUMENT);
+    CHECK(table.setSpeed(2) == BEAM_ERR_ARGUMENT);
+    CHECK(table.setScroll(LEFT, FADEOFF) == BEAM_ERR_ARGUMENT);
+    CHECK(table.play() == BEAM_ERR_ARGUMENT);
+    CHECK(table.setDimmer(100) == BEAM_ERR_ARGUMENT);
+    CHECK(sim.transactions == 0);
+
+    // a second Beam polls while the first owns the IRQ, which a deleted Beam gives back
+    Beam *owner = new Beam(5, 2, 2);
+    owner->begin();
+    CHECK(sim.isr != 0);
+    Beam other = Beam(5, 2, 2);
+    other.begin();
+    delete owner;
+    CHECK(sim.isr == 0);
+    other.begin();
+    CHECK(sim.isr != 0);
+
+    printf("%s\n", failed ? "FAILED" : "ok");
+    return failed ? 1 : 0;
+
+}
@@ -0,0 +1,29 @@
+/*
+    Runs an example sketch on the host: setup() once, then loop() as many
+    times as the first argument asks for, once by default. The dump of
+    what the four beams show at the end goes to stderr.
+*/
+
+#include "Arduino.h"
+#include "as1130.h"
+
+void setup();
+void loop();
+
+int main(int argc, char **argv){
+
+    unsigned long loops = (argc > 1) ? strtoul(argv[1], 0, 0) : 1;
+
+    setup();
+    for (unsigned long i=0; i<loops; i++){
+        loop();
+    }
+
+    static const uint8_t beams[4] = {0x36, 0x34, 0x30, 0x37};
+    fflush(stdout);
+    fprintf(stderr, "after %.3f s simulated, %lu transactions, %lu bytes, %.1f ms on the bus at %lu Hz\n",
+        sim.now / 1e9, (unsigned long)sim.transactions, (unsigned long)sim.bytes, sim.busMillis(), (unsigned long)sim.clockHz);
+    sim.dumpChain(stderr, beams, 4);
+    return 0;
+
+}
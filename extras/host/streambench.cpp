@@ -0,0 +1,99 @@
+/*
+    Sustained stream() frame rate on chains of 1 to 4 beams. A source of
+    1000 frames, each carrying its index in the top row of every beam, is
+    played at speed 1 with the sketch doing other work between polls. The
+    frame on show is checked against the index the movie should be at.
+    Also reports how many full frames per second the bus could upload.
+*/
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "beam.h"
+#include "as1130.h"
+
+#define FRAMES 1000
+
+static bool source(uint32_t index, uint8_t beam, uint8_t *frame){
+    if (index >= FRAMES){
+        return false;
+    }
+    for (uint8_t i=0; i<15; i++){
+        frame[i] = (uint8_t)(index * 7 + i * 13 + beam * 29);
+    }
+    frame[0] = index >> 8;
+    frame[1] = index & 0xFF;
+    return true;
+}
+
+//index carried by the top row of frame f
+static uint32_t topRow(const AS1130 *c, uint8_t f){
+    uint32_t v = 0;
+    for (uint8_t x=0; x<16; x++){
+        v = v << 1 | c->led(f, x, 0);
+    }
+    return v;
+}
+
+int main(){
+
+    static const uint8_t addresses[4] = {BEAMA, BEAMB, BEAMC, BEAMD};
+    long wrong = 0;
+
+    printf("beams  fps   tx/frame/beam  underruns  wrong  capacity at 400 kHz\n");
+    for (int beams=1; beams<=4; beams++){
+        Beam b = Beam(5, 9, beams);
+        b.begin();
+        b.setBusClock(400000);
+        b.stream(source, 1);
+
+        AS1130 *first = sim.chip(BEAMA);
+        uint64_t start = 0;
+        uint32_t transactions = 0, checked = 0xFFFFFFFF;
+        long checks = 0;
+        while (b.streaming()){
+            b.poll();
+            if (!start && (first->control[SHDN] & 1)){
+                start = sim.now;
+                transactions = sim.transactions;
+            }
+            if (start && (first->control[MOV] & 0x40)){
+                uint32_t index = first->movieSteps(sim.now);
+                if (index != checked && index < FRAMES){
+                    checked = index;
+                    for (int n=0; n<beams; n++){
+                        checks++;
+                        if (topRow(sim.chip(addresses[n]), index % 36) != index){
+                            wrong++;
+                        }
+                    }
+                }
+            }
+            // the sketch does other work between polls
+            sim.advance(200);
+        }
+        double seconds = (sim.now - start) / 1e9;
+        double perFrame = (double)(sim.transactions - transactions) / FRAMES / beams;
+
+        // bus time to upload one full frame to every beam, every register changing
+        uint8_t frame[15];
+        uint64_t busNanos = 0;
+        for (uint8_t pass=0; pass<2; pass++){
+            memset(frame, pass ? 0xFF : 0x00, sizeof(frame));
+            busNanos = sim.busNanos;
+            for (uint8_t f=0; f<36; f++){
+                for (int n=0; n<beams; n++){
+                    b.loadFrameFromRAM(addresses[n], f, frame);
+                }
+            }
+        }
+        double capacity = 36 / ((sim.busNanos - busNanos) / 1e9);
+
+        printf("%5d  %4.1f  %13.1f  %9u  %5ld  %.0f fps\n", beams, FRAMES / seconds, perFrame,
+            b.streamUnderruns(), wrong, capacity);
+        if (!checks){
+            wrong++;
+        }
+    }
+    return wrong ? 1 : 0;
+
+}
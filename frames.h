@@ -12,6 +12,9 @@
 ===========================================================================
 */
 
+#ifndef __FRAMES__
+#define __FRAMES__
+
 
 #define frame0 { \
   0b00000000, 0b00000000, 0b00000000, \
@@ -302,41 +305,72 @@
   0b00000000, 0b00000000, 0b00000000, \
 }
 
-const uint8_t frameList[36][15] PROGMEM = {
-    frame0,
-    frame1,
-    frame2,
-    frame3,
-    frame4,
-    frame5,
-    frame6,
-    frame7,
-    frame8,
-    frame9,
-    frame10,
-    frame11,
-    frame12,
-    frame13,
-    frame14,
-    frame15,
-    frame16,
-    frame17,
-    frame18,
-    frame19,
-    frame20,
-    frame21,
-    frame22,
-    frame23,
-    frame24,
-    frame25,
-    frame26,
-    frame27,
-    frame28,
-    frame29,
-    frame30,
-    frame31,
-    frame32,
-    frame33,
-    frame34,
-    frame35
+/*
+    draw() streams the frames above straight into the AS1130 frame registers.
+    The bitmaps are encoded into their 24 register bytes at compile time, so
+    no per-pixel work is left for the sketch. Register 2j holds the low byte
+    of cs[j] and register 2j+1 its top two bits, where cs[j] carries column
+    2j in bits 0-4 and column 2j+1 in bits 5-9 with row r at bit r.
+*/
+struct BeamBitmap {
+    uint8_t b[15];
+};
+
+constexpr uint16_t csWord(const BeamBitmap &f, uint8_t j, uint8_t r = 0){
+    return r == 5 ? 0 :
+        (((f.b[3*r + j/4] >> (7 - 2*(j%4))) & 1) << r) |
+        (((f.b[3*r + j/4] >> (6 - 2*(j%4))) & 1) << (r + 5)) |
+        csWord(f, j, r + 1);
+}
+
+constexpr uint8_t regByte(const BeamBitmap &f, uint8_t i){
+    return (i & 1) ? (csWord(f, i/2) >> 8) : (csWord(f, i/2) & 0xFF);
+}
+
+#define BEAM_FRAME_IMAGE(f) { \
+    regByte(BeamBitmap f, 0), regByte(BeamBitmap f, 1), regByte(BeamBitmap f, 2), regByte(BeamBitmap f, 3), regByte(BeamBitmap f, 4), regByte(BeamBitmap f, 5), \
+    regByte(BeamBitmap f, 6), regByte(BeamBitmap f, 7), regByte(BeamBitmap f, 8), regByte(BeamBitmap f, 9), regByte(BeamBitmap f, 10), regByte(BeamBitmap f, 11), \
+    regByte(BeamBitmap f, 12), regByte(BeamBitmap f, 13), regByte(BeamBitmap f, 14), regByte(BeamBitmap f, 15), regByte(BeamBitmap f, 16), regByte(BeamBitmap f, 17), \
+    regByte(BeamBitmap f, 18), regByte(BeamBitmap f, 19), regByte(BeamBitmap f, 20), regByte(BeamBitmap f, 21), regByte(BeamBitmap f, 22), regByte(BeamBitmap f, 23) \
+}
+
+const uint8_t frameImages[36][24] PROGMEM = {
+    BEAM_FRAME_IMAGE(frame0),
+    BEAM_FRAME_IMAGE(frame1),
+    BEAM_FRAME_IMAGE(frame2),
+    BEAM_FRAME_IMAGE(frame3),
+    BEAM_FRAME_IMAGE(frame4),
+    BEAM_FRAME_IMAGE(frame5),
+    BEAM_FRAME_IMAGE(frame6),
+    BEAM_FRAME_IMAGE(frame7),
+    BEAM_FRAME_IMAGE(frame8),
+    BEAM_FRAME_IMAGE(frame9),
+    BEAM_FRAME_IMAGE(frame10),
+    BEAM_FRAME_IMAGE(frame11),
+    BEAM_FRAME_IMAGE(frame12),
+    BEAM_FRAME_IMAGE(frame13),
+    BEAM_FRAME_IMAGE(frame14),
+    BEAM_FRAME_IMAGE(frame15),
+    BEAM_FRAME_IMAGE(frame16),
+    BEAM_FRAME_IMAGE(frame17),
+    BEAM_FRAME_IMAGE(frame18),
+    BEAM_FRAME_IMAGE(frame19),
+    BEAM_FRAME_IMAGE(frame20),
+    BEAM_FRAME_IMAGE(frame21),
+    BEAM_FRAME_IMAGE(frame22),
+    BEAM_FRAME_IMAGE(frame23),
+    BEAM_FRAME_IMAGE(frame24),
+    BEAM_FRAME_IMAGE(frame25),
+    BEAM_FRAME_IMAGE(frame26),
+    BEAM_FRAME_IMAGE(frame27),
+    BEAM_FRAME_IMAGE(frame28),
+    BEAM_FRAME_IMAGE(frame29),
+    BEAM_FRAME_IMAGE(frame30),
+    BEAM_FRAME_IMAGE(frame31),
+    BEAM_FRAME_IMAGE(frame32),
+    BEAM_FRAME_IMAGE(frame33),
+    BEAM_FRAME_IMAGE(frame34),
+    BEAM_FRAME_IMAGE(frame35)
 };
+
+#endif